@@ -0,0 +1,99 @@
+//Times parsing a large GUILD_CREATE and a batch of messages, in place like gateway messages
+//are, and with json::parse, which uses the backend the library was built with. Build the
+//library with SLEEPY_JSON_BACKEND=simdjson and without to compare, in a Release build.
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "sleepy_discord/sleepy_discord.h"
+#include "sleepy_discord/frame_pool.h"
+
+namespace {
+	std::string makeUser(int i) {
+		const std::string id = std::to_string(100000000000000000ll + i);
+		return R"({"id":")" + id + R"(","username":"user )" + std::to_string(i) +
+			R"(","discriminator":"0","global_name":"User é )" + std::to_string(i) +
+			R"(","avatar":"a_0123456789abcdef0123456789abcdef","bot":false})";
+	}
+
+	//about the size of the GUILD_CREATE of a server with 5000 members
+	std::string makeServerCreate() {
+		std::string d = R"({"id":"200000000000000000","name":"Benchmark","owner_id":"100000000000000000",)"
+			R"("icon":null,"member_count":5000,"large":true,"roles":[)";
+		for (int i = 0; i < 100; ++i)
+			d += (i ? "," : "") + (R"({"id":")" + std::to_string(300000000000000000ll + i) +
+				R"(","name":"role )" + std::to_string(i) + R"(","color":3447003,"hoist":false,"position":)" +
+				std::to_string(i) + R"(,"permissions":"2248473465835073","managed":false,"mentionable":true})");
+		d += R"(],"channels":[)";
+		for (int i = 0; i < 200; ++i)
+			d += (i ? "," : "") + (R"({"id":")" + std::to_string(400000000000000000ll + i) +
+				R"(","type":0,"name":"channel-)" + std::to_string(i) + R"(","position":)" + std::to_string(i) +
+				R"(,"topic":"a channel for benchmarking","nsfw":false,"permission_overwrites":[)"
+				R"({"id":"300000000000000001","type":0,"allow":"1024","deny":"2048"},)"
+				R"({"id":"100000000000000000","type":1,"allow":"0","deny":"8192"}]})");
+		d += R"(],"members":[)";
+		for (int i = 0; i < 5000; ++i)
+			d += (i ? "," : "") + (R"({"user":)" + makeUser(i) + R"(,"nick":null,"roles":[")" +
+				std::to_string(300000000000000000ll + i % 100) + R"("],"joined_at":"2020-01-01T00:00:00.000000+00:00",)"
+				R"("deaf":false,"mute":false})");
+		d += R"(],"presences":[)";
+		for (int i = 0; i < 1000; ++i)
+			d += (i ? "," : "") + (R"({"user":{"id":")" + std::to_string(100000000000000000ll + i) +
+				R"("},"status":"online","activities":[{"name":"a game","type":0}],"client_status":{"desktop":"online"}})");
+		d += "]}";
+		return R"({"t":"GUILD_CREATE","s":2,"op":0,"d":)" + d + "}";
+	}
+
+	std::string makeMessages() {
+		std::string messages = "[";
+		for (int i = 0; i < 100; ++i)
+			messages += (i ? "," : "") + (R"({"id":")" + std::to_string(500000000000000000ll + i) +
+				R"(","channel_id":"400000000000000000","author":)" + makeUser(i) +
+				R"(,"content":"hello \"world\" )" + std::to_string(i) + R"(","timestamp":"2020-01-01T00:00:00.000000+00:00",)"
+				R"("tts":false,"mention_everyone":false,"mentions":[],"mention_roles":[],"attachments":[],)"
+				R"("embeds":[{"title":"title","description":"description","fields":[{"name":"n","value":"v","inline":true}]}],)"
+				R"("pinned":false,"type":0})");
+		return messages + "]";
+	}
+
+	template<class Function>
+	void time(const char* name, const std::string& json, const int repeats, Function function) {
+		function(); //warm up
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < repeats; ++i)
+			function();
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "  " << name << ": " << static_cast<int>(json.length() * repeats / seconds / (1 << 20)) << " MB/s\n";
+	}
+
+	void benchmark(const char* name, const std::string& json, const int repeats) {
+		using namespace SleepyDiscord;
+		std::cout << name << " (" << json.length() / 1024 << " KB)\n";
+		FramePool pool;
+		//what the client does with gateway messages
+		time("in place, like gateway messages", json, repeats, [&]() {
+			FramePool::Lease frame = pool.acquire();
+			frame->text.assign(json);
+			frame->parse();
+		});
+		time("rapidjson, copying strings", json, repeats, [&]() {
+			FramePool::Lease frame = pool.acquire();
+			frame->getDocument().Parse(json.data(), json.length());
+		});
+		//what the library does with json it can't change, like responses
+		time("json::parse", json, repeats, [&]() {
+			FramePool::Lease frame = pool.acquire();
+			json::parse(frame->getDocument(), json.data(), json.length());
+		});
+	}
+}
+
+int main() {
+#ifdef EXISTENT_SIMDJSON
+	std::cout << "backend: simdjson\n";
+#else
+	std::cout << "backend: rapidjson\n";
+#endif
+	benchmark("GUILD_CREATE", makeServerCreate(), 100);
+	benchmark("100 messages", makeMessages(), 2000);
+}
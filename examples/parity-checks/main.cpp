@@ -0,0 +1,221 @@
+//Checks that the faster ways of reading, writing and working things out give the same
+//results as the plain ones they replace, on payloads like the ones Discord sends
+//Prints each mismatch and exits with 1 when there are any
+#include <iostream>
+#include <string>
+#include <vector>
+#include "sleepy_discord/sleepy_discord.h"
+#include "sleepy_discord/json_sax.h"
+#include "sleepy_discord/permission_cache.h"
+#include "sleepy_discord/etf.h"
+
+using namespace SleepyDiscord;
+
+namespace {
+	int checkCount = 0;
+	int failCount = 0;
+
+	void check(const std::string& name, const bool isSame, const std::string& expected = "", const std::string& actual = "") {
+		++checkCount;
+		if (isSame)
+			return;
+		++failCount;
+		std::cout << "mismatch: " << name << "\n";
+		if (!expected.empty() || !actual.empty())
+			std::cout << "  expected " << expected << "\n  got      " << actual << "\n";
+	}
+
+	std::string write(const json::Value& value) {
+		rapidjson::StringBuffer buffer;
+		rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+		value.Accept(writer);
+		return std::string(buffer.GetString(), buffer.GetSize());
+	}
+
+	//how objects were written before stringifyObj wrote them straight into a buffer
+	template<class Object>
+	std::string writeWithToJSON(const Object& object) {
+		rapidjson::MemoryPoolAllocator<> allocator;
+		return write(json::toJSON(object, allocator));
+	}
+
+	template<class Object>
+	Object afterFromJSON(Object object) {
+		json::AfterFromJSON<Object>::apply(object);
+		return object;
+	}
+
+	//fromJSONByField is the reference for the other ways of reading
+	template<class Object>
+	void checkReading(const char* name, const std::string& payload) {
+		rapidjson::Document document;
+		document.Parse(payload.data(), payload.length());
+		json::Value& value = document;
+
+		Object byField;
+		json::fromJSONByField(byField, value);
+		const std::string expected = writeWithToJSON(afterFromJSON(byField));
+
+		const Object constructed(value);
+		check(std::string(name) + " constructor", expected == writeWithToJSON(constructed), expected, writeWithToJSON(constructed));
+#ifdef SLEEPY_ONE_PASS_FROM_JSON
+		Object onePass;
+		json::fromJSONInOnePass(onePass, value);
+		const std::string onePassJSON = writeWithToJSON(afterFromJSON(onePass));
+		check(std::string(name) + " one pass", expected == onePassJSON, expected, onePassJSON);
+#endif
+#ifdef SLEEPY_SAX_FROM_JSON
+		Object sax;
+		const bool isSAXRead = json::SAX::fromJSON(sax, payload);
+		check(std::string(name) + " SAX", isSAXRead && expected == writeWithToJSON(sax), expected, writeWithToJSON(sax));
+		std::string insituPayload = payload;
+		Object saxInsitu;
+		const bool isSAXInsituRead = json::SAX::fromJSONInsitu(saxInsitu, &insituPayload[0]);
+		check(std::string(name) + " SAX in place", isSAXInsituRead && expected == writeWithToJSON(saxInsitu), expected, writeWithToJSON(saxInsitu));
+#endif
+		const std::string stringified = json::stringifyObj(constructed);
+		check(std::string(name) + " stringifyObj", expected == stringified, expected, stringified);
+	}
+
+	//ETF gives the same values as JSON, except that numbers that don't fit in 32 bits become
+	//strings, like snowflakes are in JSON, so the payloads only have smaller numbers
+	template<class Object>
+	void checkETF(const char* name, const std::string& payload) {
+		rapidjson::Document fromJSON;
+		fromJSON.Parse(payload.data(), payload.length());
+		std::string etf;
+		const bool isEncoded = ETF::encodeJSON(payload, etf);
+		rapidjson::Document fromETF;
+		const bool isDecoded = isEncoded && ETF::decode(etf.data(), etf.length(), fromETF, fromETF.GetAllocator());
+		check(std::string(name) + " ETF round trip", isDecoded && write(fromJSON) == write(fromETF), write(fromJSON), write(fromETF));
+		if (!isDecoded)
+			return;
+		const std::string expected = writeWithToJSON(Object(static_cast<json::Value&>(fromJSON)));
+		const std::string actual = writeWithToJSON(Object(static_cast<json::Value&>(fromETF)));
+		check(std::string(name) + " from ETF", expected == actual, expected, actual);
+	}
+
+	Role makeRole(const char* ID, const Permission permissions) {
+		Role role;
+		role.ID = ID;
+		role.permissions = permissions;
+		return role;
+	}
+
+	ServerMember makeMember(const char* ID, const std::vector<const char*>& roles) {
+		ServerMember member;
+		member.user.ID = ID;
+		member.ID = member.user.ID;
+		for (const char* role : roles)
+			member.roles.push_back(Snowflake<Role>(role));
+		return member;
+	}
+
+	Overwrite makeOverwrite(const char* ID, const Permission allow, const Permission deny) {
+		Overwrite overwrite;
+		overwrite.ID = ID;
+		overwrite.allow = allow;
+		overwrite.deny = deny;
+		return overwrite;
+	}
+
+	//getPermissions is the reference for ChannelPermissions and PermissionCache
+	void checkPermissions() {
+		Server server;
+		server.ID = "1";
+		server.ownerID = "100";
+		server.roles.insert(makeRole("1", Permission::VIEW_CHANNEL | Permission::SEND_MESSAGES)); //@everyone
+		server.roles.insert(makeRole("10", Permission::ADMINISTRATOR));
+		server.roles.insert(makeRole("11", Permission::MANAGE_MESSAGES));
+		server.roles.insert(makeRole("12", Permission::NONE));
+		server.members.insert(makeMember("100", {}));            //owner
+		server.members.insert(makeMember("101", { "10" }));      //admin
+		server.members.insert(makeMember("102", { "99", "11" })); //a role that's not in the server
+		server.members.insert(makeMember("103", { "11", "12" }));
+		server.members.insert(makeMember("104", {}));
+
+		std::vector<Channel> channels(3);
+		channels[0].ID = "200"; //no overwrites
+		channels[1].ID = "201";
+		channels[1].permissionOverwrites = {
+			makeOverwrite("1", Permission::NONE, Permission::SEND_MESSAGES),
+			makeOverwrite("11", Permission::SEND_MESSAGES, Permission::NONE),
+			makeOverwrite("12", Permission::NONE, Permission::VIEW_CHANNEL),
+			makeOverwrite("99", Permission::MANAGE_MESSAGES, Permission::NONE),
+			makeOverwrite("104", Permission::SEND_MESSAGES, Permission::NONE),
+		};
+		channels[2].ID = "202"; //more than one overwrite for an id, only the first is used
+		channels[2].permissionOverwrites = {
+			makeOverwrite("1", Permission::NONE, Permission::VIEW_CHANNEL),
+			makeOverwrite("1", Permission::VIEW_CHANNEL, Permission::NONE),
+			makeOverwrite("11", Permission::VIEW_CHANNEL, Permission::NONE),
+			makeOverwrite("11", Permission::NONE, Permission::ALL),
+			makeOverwrite("104", Permission::NONE, Permission::SEND_MESSAGES),
+			makeOverwrite("104", Permission::VIEW_CHANNEL, Permission::NONE),
+		};
+
+		PermissionCache cache;
+		for (const Channel& channel : channels) {
+			const ChannelPermissions channelPermissions(server, channel);
+			const std::vector<Permission> permissions = channelPermissions.getPermissions();
+			const std::vector<Snowflake<User>>& memberIDs = channelPermissions.getMemberIDs();
+			check("ChannelPermissions size in " + channel.ID.string(), permissions.size() == server.members.size());
+			for (std::size_t i = 0; i < memberIDs.size() && i < permissions.size(); ++i) {
+				const ServerMember& member = *server.findMember(memberIDs[i]);
+				const Permission expected = getPermissions(server, member, channel);
+				const std::string name = "member " + memberIDs[i].string() + " in " + channel.ID.string();
+				check("ChannelPermissions " + name, permissions[i] == expected,
+					std::to_string(static_cast<int64_t>(expected)), std::to_string(static_cast<int64_t>(permissions[i])));
+				//twice, so that the second one comes from the cache
+				for (int repeat = 0; repeat < 2; ++repeat) {
+					const Permission cached = cache.getPermissions(server, member, channel);
+					check("PermissionCache " + name, cached == expected,
+						std::to_string(static_cast<int64_t>(expected)), std::to_string(static_cast<int64_t>(cached)));
+				}
+			}
+		}
+	}
+}
+
+int main() {
+	const std::string user = R"({"id":"175928847299117063","username":"user é","discriminator":"0","global_name":null,"avatar":"a_0123456789abcdef","bot":true})";
+	const std::string member = R"({"user":)" + user + R"(,"roles":["41771983423143936","41771983423143937"],"nick":null,)"
+		R"("joined_at":"2020-01-01T00:00:00.000000+00:00","deaf":false,"mute":true,"permissions":"8","pending":false,"flags":0})";
+	const std::string channel = R"({"id":"41771983423143937","type":0,"guild_id":"41771983423143936","name":"general","position":0,)"
+		R"("topic":null,"nsfw":false,"rate_limit_per_user":0,"parent_id":null,"last_message_id":"1",)"
+		R"("permission_overwrites":[{"id":"41771983423143936","type":0,"allow":"0","deny":"1024"},{"id":"175928847299117063","type":1,"allow":"1024","deny":"0"}]})";
+	//a server from GET /guilds/{id}?with_counts=true, since fields that are missing would be left uninitialized
+	const std::string server = R"({"id":"41771983423143936","name":"server","icon":null,"owner_id":"175928847299117063",)"
+		R"("afk_timeout":300,"afk_channel_id":null,"verification_level":1,"default_message_notifications":0,"explicit_content_filter":0,)"
+		R"("mfa_level":0,"premium_tier":2,"large":false,"unavailable":false,"member_count":2,"widget_enabled":false,"permissions":"1071698660937",)"
+		R"("system_channel_flags":2,"max_video_channel_users":25,"approximate_member_count":2,"approximate_presence_count":1,)"
+		R"("roles":[{"id":"41771983423143936","name":"@everyone","permissions":"1071698660929","color":0,"hoist":false,"position":0,"managed":false,"mentionable":false},)"
+		R"({"id":"41771983423143937","name":"bots","permissions":"8","color":3447003,"hoist":true,"position":1,"managed":true,"mentionable":false,"tags":{"bot_id":"175928847299117063"}}],)"
+		R"("emojis":[{"id":"41771983429993937","name":"e","roles":[],"animated":false}],"features":["COMMUNITY"],)"
+		R"("channels":[)" + channel + R"(],"members":[)" + member + "," + member + R"(],"unknown_field":[[],{}],"name":"duplicate name"})";
+	const std::string message = R"({"id":"334385199974967042","channel_id":"41771983423143937","guild_id":"41771983423143936","author":)" + user + ","
+		R"("member":{"roles":[],"joined_at":"2020-01-01T00:00:00.000000+00:00"},"content":"hello \"world\" é\n",)"
+		R"("timestamp":"2020-01-01T00:00:00.000000+00:00","edited_timestamp":null,"tts":false,"mention_everyone":false,)"
+		R"("mentions":[)" + user + R"(],"mention_roles":["41771983423143937"],"attachments":[],)"
+		R"("embeds":[{"title":"title","color":16711680,"fields":[{"name":"a","value":"b","inline":true}]}],)"
+		R"("reactions":[{"count":1,"me":false,"emoji":{"id":null,"name":"x"}}],"pinned":false,"type":0,"flags":4,)"
+		R"("components":[{"type":1,"components":[{"type":2,"style":1,"label":"button","custom_id":"id"}]}]})";
+	const std::string ready = R"({"v":10,"user":)" + user + R"(,"private_channels":[],"guilds":[{"id":"41771983423143936","unavailable":true}],)"
+		R"("session_id":"abcdef","shard":[0,2]})";
+
+	checkReading<User>("user", user);
+	checkReading<ServerMember>("member", member);
+	checkReading<Channel>("channel", channel);
+	checkReading<Server>("server", server);
+	checkReading<Message>("message", message);
+	checkReading<Ready>("ready", ready);
+
+	checkETF<Message>("message", message);
+	checkETF<Server>("server", server);
+	checkETF<Ready>("ready", ready);
+
+	checkPermissions();
+
+	std::cout << checkCount << " checks, " << failCount << " mismatches\n";
+	return failCount == 0 ? 0 : 1;
+}
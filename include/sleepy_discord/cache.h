@@ -11,6 +11,7 @@ namespace SleepyDiscord {
 
 	//This is basicity an unordered_map made to work with the library
 	//only works with Discord Object with an id
+	//Objects are stored in the map's nodes, so references to them stay valid until they are erased
 	template<class _Type>
 	struct Cache : public CacheParent<_Type> {
 	public:
@@ -18,6 +19,8 @@ namespace SleepyDiscord {
 		using Parent = CacheParent<_Type>;
 		using std::unordered_map<typename Snowflake<_Type>::RawType, _Type>::unordered_map;
 		using Key = typename Snowflake<Type>::RawType;
+		//iterating gives the objects instead of key value pairs, so Cache works like other containers
+		using value_type = Type;
 		Cache() : Parent() {}
 		Cache(Parent map) : Parent(map) {}
 		template<class InputIterator>
@@ -33,17 +36,17 @@ namespace SleepyDiscord {
 			//standard iterator values
 			using self_type = const_iterator;
 			using value_type = Type;
-			using reference = Type&;
-			using pointer = Type*;
+			using reference = const Type&;
+			using pointer = const Type*;
 			using iterator_category = typename Value::iterator_category;
 			using difference_type = typename Value::difference_type;
 			const_iterator(Value iter) : value(iter) {}
-			inline self_type operator++() { return value++; }
-			inline self_type operator++(int junk) { return value.operator++(junk); }
-			inline reference operator*() { return value->second; }
-			inline pointer operator->() { return &value->second; }
-			inline bool operator==(const self_type& right) { return value == right.value; }
-			inline bool operator!=(const self_type& right) { return value != value.value; }
+			inline self_type& operator++() { ++value; return *this; }
+			inline self_type operator++(int) { return self_type(value++); }
+			inline reference operator*() const { return value->second; }
+			inline pointer operator->() const { return &value->second; }
+			inline bool operator==(const self_type& right) const { return value == right.value; }
+			inline bool operator!=(const self_type& right) const { return value != right.value; }
 			inline Value getParent() { return value; }
 		private:
 			Value value;
@@ -60,13 +63,13 @@ namespace SleepyDiscord {
 			using iterator_category = typename Value::iterator_category;
 			using difference_type = typename Value::difference_type;
 			iterator(Value iter) : value(iter) {}
-			inline self_type operator++() { return value++; }
-			inline self_type operator++(int junk) { return value.operator++(junk); }
-			inline reference operator*() { return value->second; }
-			inline pointer operator->() { return &value->second; }
-			inline bool operator==(const self_type& right) { return value == right.value; }
-			inline bool operator!=(const self_type& right) { return value != right.value; }
-			inline operator const_iterator() { return const_iterator(value); }
+			inline self_type& operator++() { ++value; return *this; }
+			inline self_type operator++(int) { return self_type(value++); }
+			inline reference operator*() const { return value->second; }
+			inline pointer operator->() const { return &value->second; }
+			inline bool operator==(const self_type& right) const { return value == right.value; }
+			inline bool operator!=(const self_type& right) const { return value != right.value; }
+			inline operator const_iterator() const { return const_iterator(value); }
 			inline Value getParent() { return value; }
 		private:
 			Value value;
@@ -85,10 +88,10 @@ namespace SleepyDiscord {
 		}
 
 		inline const_iterator end() const {
-			return const_iterator(Parent::begin());
+			return const_iterator(Parent::end());
 		}
 
-		//Worse then linear time
+		//Linear time, finding the object in each container should be constant time
 		template<class Container, class Object>
 		const_iterator findOneWithObject(Container Type::*list, const Snowflake<Object>& objectID) {
 			return const_iterator(
@@ -99,18 +102,22 @@ namespace SleepyDiscord {
 			);
 		}
 
-		std::pair<iterator,bool> insert(Type& value) {
-			std::pair<typename Parent::iterator,bool> pair = Parent::insert(typename Parent::value_type(value.ID, value));
+		std::pair<iterator,bool> insert(const Type& value) {
+			std::pair<typename Parent::iterator,bool> pair = Parent::emplace(value.ID.raw(), value);
 			return {iterator(pair.first), pair.second};
 		}
 
-		template<class... Args>
-		std::pair<iterator, bool> emplace(const json::Value& value) {
-			const json::Value& ID = value["id"];
-			std::pair<typename Parent::iterator,bool> pair = Parent::emplace(std::string(ID.GetString(), ID.GetStringLength()), value);
+		std::pair<iterator,bool> insert(Type&& value) {
+			Key key = value.ID.raw();
+			std::pair<typename Parent::iterator,bool> pair = Parent::emplace(std::move(key), std::move(value));
 			return {iterator(pair.first), pair.second};
 		}
 
+		//the object is made first, since not every object has its id in "id", like members
+		std::pair<iterator, bool> emplace(const json::Value& value) {
+			return insert(Type(value));
+		}
+
 		iterator find(const Key& key) {
 			return iterator(Parent::find(key));
 		}
@@ -127,18 +134,22 @@ namespace SleepyDiscord {
 			return iterator(Parent::erase(first.getParent(), last.getParent()));
 		}
 
-		//In the case of push_back needed
-		//remove /**/
-		/*
+		std::size_t erase(const Key& key) {
+			return Parent::erase(key);
+		}
+
 		//Does not add to the end, this is just for compatability for
-		//some SleepyDiscord functions
+		//some SleepyDiscord functions, like turning json arrays into containers
 		inline void push_back(const Type& value) {
 			insert(value);
 		}
 
 		inline void push_back(Type&& value) {
+			insert(std::move(value));
+		}
+
+		inline void push_front(const Type& value) {
 			insert(value);
 		}
-		*/
 	};
 }
\ No newline at end of file
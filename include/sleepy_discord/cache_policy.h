@@ -0,0 +1,137 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <unordered_map>
+#include "snowflake.h"
+
+namespace SleepyDiscord {
+	//How much of one type of object a cache keeps, for each server
+	struct CachePolicy {
+		enum Mode : int8_t {
+			None = 0, //nothing is kept
+			Full = 1, //everything is kept until Discord says it's gone
+			LRU  = 2, //only the maxSize most recently used objects are kept
+			TTL  = 3, //objects are kept until they haven't been used for maxAge milliseconds
+		};
+		Mode mode = Full;
+		std::size_t maxSize = 0;
+		time_t maxAge = 0;
+
+		static inline CachePolicy none() { return { None }; }
+		static inline CachePolicy full() { return { Full }; }
+		static inline CachePolicy lru(const std::size_t maxSize) { return { LRU, maxSize }; }
+		static inline CachePolicy ttl(const time_t maxAge) { return { TTL, 0, maxAge }; }
+
+		//full and none don't need to know when objects are used
+		inline bool isTracked() const { return mode == LRU || mode == TTL; }
+	};
+
+	//what a cache did with one type of object
+	struct CacheCounters {
+		using Counter = std::atomic<uint64_t>;
+		Counter added{ 0 };
+		Counter removed{ 0 };   //removed because Discord said they were gone
+		Counter evicted{ 0 };   //removed by LRU
+		Counter expired{ 0 };   //removed by TTL
+		Counter skipped{ 0 };   //not added because the policy is none
+
+		CacheCounters() = default;
+		CacheCounters(const CacheCounters& other) { *this = other; }
+		CacheCounters& operator=(const CacheCounters& other) {
+			added   = other.added.load();
+			removed = other.removed.load();
+			evicted = other.evicted.load();
+			expired = other.expired.load();
+			skipped = other.skipped.load();
+			return *this;
+		}
+	};
+
+	//Keeps the order objects were used in, for LRU and TTL policies
+	//Note: not thread safe, it's used with the lock of the server it's for
+	class CacheTracker {
+	public:
+		using Key = SnowflakeRaw::Type;
+		using Clock = std::chrono::steady_clock;
+
+		CacheTracker() = default;
+		//positions point into order, so copies need their own
+		CacheTracker(const CacheTracker& other) : order(other.order) { reindex(); }
+		CacheTracker& operator=(const CacheTracker& other) {
+			order = other.order;
+			reindex();
+			return *this;
+		}
+		CacheTracker(CacheTracker&&) = default;
+		CacheTracker& operator=(CacheTracker&&) = default;
+
+		//moves the object to the front, adding it if it's not tracked yet
+		void use(const Key& key, const Clock::time_point now) {
+			auto found = positions.find(key);
+			if (found != positions.end()) {
+				found->second->lastUse = now;
+				order.splice(order.begin(), order, found->second);
+				return;
+			}
+			order.push_front(Entry{ key, now });
+			positions.emplace(key, order.begin());
+		}
+
+		void erase(const Key& key) {
+			auto found = positions.find(key);
+			if (found == positions.end())
+				return;
+			order.erase(found->second);
+			positions.erase(found);
+		}
+
+		void clear() {
+			order.clear();
+			positions.clear();
+		}
+
+		//calls evict with the key of each object the policy doesn't keep
+		//and whether it was evicted by LRU (false) or expired by TTL (true)
+		template<class Evict>
+		void trim(const CachePolicy& policy, const Clock::time_point now, Evict evict) {
+			while (!order.empty()) {
+				const Entry& oldest = order.back();
+				bool isExpired = false;
+				if (policy.mode == CachePolicy::LRU) {
+					if (order.size() <= policy.maxSize)
+						return;
+				} else if (policy.mode == CachePolicy::TTL) {
+					if (now - oldest.lastUse < std::chrono::milliseconds(policy.maxAge))
+						return;
+					isExpired = true;
+				} else {
+					return;
+				}
+				const Key key = oldest.key;
+				positions.erase(key);
+				order.pop_back();
+				evict(key, isExpired);
+			}
+		}
+
+		inline std::size_t size() const { return order.size(); }
+
+	private:
+		struct Entry {
+			Key key;
+			Clock::time_point lastUse;
+		};
+
+		void reindex() {
+			positions.clear();
+			for (auto entry = order.begin(); entry != order.end(); ++entry)
+				positions.emplace(entry->key, entry);
+		}
+
+		std::list<Entry> order; //most recently used first
+		std::unordered_map<Key, std::list<Entry>::iterator> positions;
+	};
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+#include "server.h"
+#include "gateway.h"
+
+namespace SleepyDiscord {
+	//Saves a ServerCache and the gateway session to a file, so that a restarted process can
+	//resume the session with a warm cache instead of waiting for every GUILD_CREATE again
+	//The file has a header, the session and then each server, and each of these are ETF terms
+	//with their length in front. Loading maps the file into memory and decodes the servers
+	//straight from it.
+	//Note: save after the client stops getting events, like in onQuit, so that the sequence
+	//of the session matches the cache. Resuming replays the events after it.
+	namespace CacheSnapshot {
+		constexpr uint32_t VERSION = 1;
+
+		//returns false if the file couldn't be written
+		bool save(const std::string& path, const ServerCache& cache, const GatewaySession& session = {});
+		//adds the servers in the snapshot to the cache, returns false if the file couldn't be
+		//read or isn't a snapshot of this version
+		bool load(const std::string& path, ServerCache& cache, GatewaySession* session = nullptr);
+	}
+}
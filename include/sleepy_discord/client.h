@@ -14,6 +14,8 @@
 #include "message.h"
 #include "channel.h"
 #include "server.h"
+#include "message_cache.h"
+#include "permission_cache.h"
 #include "invite.h"
 #include "webhook.h"
 #include "permissions.h"
@@ -24,19 +26,25 @@
 
 #include "error.h"
 #include "session.h"
+#include "session_pool.h"
+#include "frame_pool.h"
+#include "keyed_dispatcher.h"
 #include "common_return_types.h"
 #include "message_receiver.h"
 #include "timer.h"
 #include "voice_connection.h"
 #include "asio_schedule.h"
 #include "rate_limiter.h"
+#include "routes.h"
 #include "compression.h"
+#include "etf.h"
 
 namespace SleepyDiscord {
 #define TOKEN_SIZE 64
 
 	struct Request;
 	class BaseDiscordClient;
+	template<class Client> class ShardManager;
 
 	//to dos
 	//custom rapid json error
@@ -113,6 +121,11 @@ namespace SleepyDiscord {
 			inline void operator()() const {
 				client.request(method, url, jsonParameters, multipartParameters, callback, mode);
 			}
+			//makes the request without checking the rate limiter
+			inline void perform() const {
+				client.performRequest(method, url, url.bucket(method), jsonParameters, multipartParameters,
+					callback, mode, client.getEpochTimeMillisecond());
+			}
 		};
 
 		template<class ParmType>
@@ -134,6 +147,7 @@ namespace SleepyDiscord {
 		}
 
 		const Route path(const char* source, std::initializer_list<std::string> values = {});
+		const Route path(const RouteTemplate& route, std::initializer_list<std::string> values = {});
 
 #ifndef SLEEPY_DEFAULT_REQUEST_MODE
 	#ifdef SLEEPY_DEFAULT_REQUEST_MODE_ASYNC
@@ -326,66 +340,66 @@ namespace SleepyDiscord {
 		//This way, we can use use the EmptyOptions type as default and still let uses options via a vector or list without any copying
 		template<typename Options = const AppCommand::EmptyOptions>
 		ObjectResponse<AppCommand> createGlobalAppCommand(
-			Snowflake<DiscordObject>::RawType applicationID, std::string name, std::string description, Options options = (std::nullptr_t)nullptr,
+			Snowflake<DiscordObject> applicationID, std::string name, std::string description, Options options = (std::nullptr_t)nullptr,
 			bool defaultPermission = true, AppCommand::Type type = AppCommand::Type::NONE,
 			RequestSettings<ObjectResponse<AppCommand>> settings = {}
 		) {
-			return ObjectResponse<AppCommand>{ request(Post, path("applications/{application.id}/commands", { applicationID }), settings,
+			return ObjectResponse<AppCommand>{ request(Post, path(Routes::globalAppCommands, { applicationID }), settings,
 				createApplicationCommandBody(name, description, options, defaultPermission, type)) };
 		}
 		template<typename Options = const AppCommand::EmptyOptions>
 		ObjectResponse<AppCommand> editGlobalAppCommand(
-			Snowflake<DiscordObject>::RawType applicationID, Snowflake<AppCommand> commandID, std::string name, std::string description, Options options = (std::nullptr_t)nullptr,
+			Snowflake<DiscordObject> applicationID, Snowflake<AppCommand> commandID, std::string name, std::string description, Options options = (std::nullptr_t)nullptr,
 			bool defaultPermission = true, AppCommand::Type type = AppCommand::Type::NONE,
 			RequestSettings<ObjectResponse<AppCommand>> settings = {}
 		) {
 			return ObjectResponse<AppCommand>{ request(Patch,
-				path("applications/{application.id}/commands/{command.id}", { applicationID, commandID }), settings,
+				path(Routes::globalAppCommand, { applicationID, commandID }), settings,
 				createApplicationCommandBody(name, description, options, defaultPermission, type, true)) };
 		}
-		ArrayResponse<AppCommand> getGlobalAppCommands(Snowflake<DiscordObject>::RawType applicationID, RequestSettings<ArrayResponse<AppCommand>> settings = {});
-		ObjectResponse<AppCommand> getGlobalAppCommand(Snowflake<DiscordObject>::RawType applicationID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<AppCommand>> settings = {});
-		BoolResponse deleteGlobalAppCommand(Snowflake<DiscordObject>::RawType applicationID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings = {});
+		ArrayResponse<AppCommand> getGlobalAppCommands(Snowflake<DiscordObject> applicationID, RequestSettings<ArrayResponse<AppCommand>> settings = {});
+		ObjectResponse<AppCommand> getGlobalAppCommand(Snowflake<DiscordObject> applicationID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<AppCommand>> settings = {});
+		BoolResponse deleteGlobalAppCommand(Snowflake<DiscordObject> applicationID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings = {});
 		template<typename Options = const AppCommand::EmptyOptions>
 		ObjectResponse<AppCommand> createServerAppCommand(
-			Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, std::string name, std::string description,
+			Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, std::string name, std::string description,
 			Options options = (std::nullptr_t)nullptr, bool defaultPermission = true, AppCommand::Type type = AppCommand::Type::NONE,
 			RequestSettings<ObjectResponse<AppCommand>> settings = {}
 		) {
 			return ObjectResponse<AppCommand>{ request(Post,
-				path("applications/{application.id}/guilds/{guild.id}/commands", { applicationID, serverID }), settings,
+				path(Routes::serverAppCommands, { applicationID, serverID }), settings,
 				createApplicationCommandBody(name, description, options, defaultPermission, type, true)) };
 		}
 		template<typename Options = const AppCommand::EmptyOptions>
 		ObjectResponse<AppCommand> editServerAppCommand(
-			Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, std::string name,
+			Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, std::string name,
 			std::string description, Options options = (std::nullptr_t)nullptr,
 			RequestSettings<ObjectResponse<AppCommand>> settings = {}
 		) {
 			return ObjectResponse<AppCommand>{ request(Patch,
-				path("applications/{application.id}/guilds/{guild.id}/commands/{command.id}", { applicationID, serverID, commandID }), settings,
+				path(Routes::serverAppCommand, { applicationID, serverID, commandID }), settings,
 				createApplicationCommandBody(name, description, options, true)) };
 		}
-		ArrayResponse<AppCommand> getServerAppCommands(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<AppCommand>> settings = {});
-		ObjectResponse<AppCommand> getServerAppCommand(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<AppCommand>> settings = {});
-		BoolResponse deleteServerAppCommand(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings = {});
+		ArrayResponse<AppCommand> getServerAppCommands(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<AppCommand>> settings = {});
+		ObjectResponse<AppCommand> getServerAppCommand(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<AppCommand>> settings = {});
+		BoolResponse deleteServerAppCommand(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings = {});
 		template<typename Type>
 		BoolResponse createInteractionResponse(Snowflake<Interaction> interactionID, std::string token, Type response, RequestSettings<BoolResponse> settings = {}) {
 			static_assert(std::is_same<InteractionCallbackType, decltype(response.type)>::value, "response needs to be a Interaction::Response Type");
-			return { request(Post, path("interactions/{interaction.id}/{interaction.token}/callback", { interactionID, token }), settings, json::stringifyObj(response)), EmptyRespFn() };
-		}
-		ObjectResponse<Message> editOriginalInteractionResponse(Snowflake<DiscordObject>::RawType applicationID, std::string interactionToken, EditWebhookParams params, RequestSettings<BoolResponse> settings = {});
-		BoolResponse deleteOriginalInteractionResponse(Snowflake<DiscordObject>::RawType applicationID, std::string interactionToken, RequestSettings<BoolResponse> settings = {});
-		ObjectResponse<Message> createFollowupMessage(Snowflake<DiscordObject>::RawType applicationID, std::string interactionToken, FollowupMessage params, RequestSettings<BoolResponse> settings = {});
-		ObjectResponse<Message> editFollowupMessage(Snowflake<DiscordObject>::RawType applicationID, std::string interactionToken, Snowflake<Message> messageID, EditWebhookParams params, RequestSettings<BoolResponse> settings = {});
-		BoolResponse deleteFollowupMessage(Snowflake<DiscordObject>::RawType applicationID, std::string interactionToken, Snowflake<Message> messageID, RequestSettings<BoolResponse> settings = {});
-		BoolResponse batchEditAppCommandPermissions(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, std::vector<ServerAppCommandPermissions> permissions, RequestSettings<BoolResponse> settings = {});
-		BoolResponse editServerAppCommandPermission(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, std::vector<AppCommand::Permissions> permissions, RequestSettings<BoolResponse> settings = {});
-		ArrayResponse<ServerAppCommandPermissions> getServerAppCommandPermissions(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<ServerAppCommandPermissions>> settings = {});
-		ObjectResponse<ServerAppCommandPermissions> getAppCommandPermissions(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<ServerAppCommandPermissions>> settings = {});
+			return { request(Post, path(Routes::interactionCallback, { interactionID, token }), settings, json::stringifyObj(response)), EmptyRespFn() };
+		}
+		ObjectResponse<Message> editOriginalInteractionResponse(Snowflake<DiscordObject> applicationID, std::string interactionToken, EditWebhookParams params, RequestSettings<BoolResponse> settings = {});
+		BoolResponse deleteOriginalInteractionResponse(Snowflake<DiscordObject> applicationID, std::string interactionToken, RequestSettings<BoolResponse> settings = {});
+		ObjectResponse<Message> createFollowupMessage(Snowflake<DiscordObject> applicationID, std::string interactionToken, FollowupMessage params, RequestSettings<BoolResponse> settings = {});
+		ObjectResponse<Message> editFollowupMessage(Snowflake<DiscordObject> applicationID, std::string interactionToken, Snowflake<Message> messageID, EditWebhookParams params, RequestSettings<BoolResponse> settings = {});
+		BoolResponse deleteFollowupMessage(Snowflake<DiscordObject> applicationID, std::string interactionToken, Snowflake<Message> messageID, RequestSettings<BoolResponse> settings = {});
+		BoolResponse batchEditAppCommandPermissions(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, std::vector<ServerAppCommandPermissions> permissions, RequestSettings<BoolResponse> settings = {});
+		BoolResponse editServerAppCommandPermission(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, std::vector<AppCommand::Permissions> permissions, RequestSettings<BoolResponse> settings = {});
+		ArrayResponse<ServerAppCommandPermissions> getServerAppCommandPermissions(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<ServerAppCommandPermissions>> settings = {});
+		ObjectResponse<ServerAppCommandPermissions> getAppCommandPermissions(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<ServerAppCommandPermissions>> settings = {});
 		template<typename Options = const AppCommand::EmptyOptions>
 		ObjectResponse<AppCommand> createAppCommand(
-			Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, std::string name, std::string description,
+			Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, std::string name, std::string description,
 			Options options = (std::nullptr_t)nullptr, bool defaultPermission = true, AppCommand::Type type = AppCommand::Type::NONE,
 			RequestSettings<ObjectResponse<AppCommand>> settings = {}
 		) {
@@ -394,18 +408,18 @@ namespace SleepyDiscord {
 		}
 		template<typename Options = const AppCommand::EmptyOptions>
 		ObjectResponse<AppCommand> editAppCommand(
-			Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, std::string name,
+			Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, std::string name,
 			std::string description, Options options = (std::nullptr_t)nullptr,
 			RequestSettings<ObjectResponse<AppCommand>> settings = {}
 		) {
 			if (serverID.empty()) return editGlobalAppCommand(applicationID, commandID, name, description, options, settings);
 			return editServerAppCommand(applicationID, serverID, commandID, name, description, options, settings);
 		}
-		ArrayResponse<AppCommand> getAppCommands(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<AppCommand>> settings = {});
-		ObjectResponse<AppCommand> getAppCommand(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<AppCommand>> settings = {});
-		BoolResponse deleteAppCommand(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings = {});
-		BoolResponse bulkOverwriteServerAppCommands(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, std::vector<AppCommand> commands, RequestSettings<BoolResponse> settings = {});
-		BoolResponse bulkOverwriteGlobalAppCommands(Snowflake<DiscordObject>::RawType applicationID, std::vector<AppCommand> commands, RequestSettings<BoolResponse> settings = {});
+		ArrayResponse<AppCommand> getAppCommands(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<AppCommand>> settings = {});
+		ObjectResponse<AppCommand> getAppCommand(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<AppCommand>> settings = {});
+		BoolResponse deleteAppCommand(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings = {});
+		BoolResponse bulkOverwriteServerAppCommands(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, std::vector<AppCommand> commands, RequestSettings<BoolResponse> settings = {});
+		BoolResponse bulkOverwriteGlobalAppCommands(Snowflake<DiscordObject> applicationID, std::vector<AppCommand> commands, RequestSettings<BoolResponse> settings = {});
 
 		//stage instances
 		ObjectResponse<User> createStageInstance(Snowflake<Channel> channelID, std::string topic, StageInstance::PrivacyLevel privacyLevel = StageInstance::PrivacyLevel::NotSet, RequestSettings<ObjectResponse<User>> settings = {});
@@ -431,6 +445,12 @@ namespace SleepyDiscord {
 		const bool isBot() { return bot; }
 		const Snowflake<User> getID() { return userID; }
 		void setShardID(int _shardID, int _shardCount); //Note: must be called before run or reconnect
+		//the session to save, so that another process can resume it
+		GatewaySession getSession();
+		//resumes the session when connecting instead of identifying, if Discord says the
+		//session can't be resumed, the client identifies like usual
+		//Note: must be called before run or reconnect
+		void resumeSession(const GatewaySession& session);
 		const int getShardID() { return shardID; }
 		const int getShardCount() { return shardCount; }
 		const bool hasIntents() { return intentsIsSet; }
@@ -439,6 +459,18 @@ namespace SleepyDiscord {
 		void quit() { quit(false); }	//public function for diconnecting
 		virtual void run();
 
+		//sessions used for REST requests are kept alive here between requests
+		inline SessionPool& getSessionPool() { return sessionPool; }
+		//gateway messages are parsed into frames that are reused
+		inline FramePool& getFramePool() { return framePool; }
+
+		//decides when the client sends IDENTIFY, it's given a function to call once it's time
+		//without one, the client identifies as soon as the gateway says hello
+		using IdentifyHandler = std::function<void(std::function<void()> identify)>;
+		inline void setIdentifyHandler(IdentifyHandler handler) { identifyHandler = std::move(handler); }
+		//the url from gateway/bot, so that connecting doesn't need to request it again
+		inline void setGatewayURL(const std::string& url) { gatewayURL = url; }
+
 		//array of intents
 		template<class Container, typename T = typename Container::value_type>
 		void setIntents(const Container& listOfIntents) {
@@ -468,10 +500,18 @@ namespace SleepyDiscord {
 			if (value) useCompression<DefaultCompression>();
 			else scheduleHandler = nullptr;
 #else
-			assert(((void)"No default compress handler, use zlib-ng or use template function instead", value == false));
+			assert(((void)"No default compress handler, use zlib, zlib-ng, zstd or use template function instead", value == false));
 #endif
 		}
 
+		//needs to be set before connecting, ETF needs a websocket library that can send binary messages
+		inline void setGatewayEncoding(GatewayEncoding encoding) { gatewayEncoding = encoding; }
+		inline GatewayEncoding getGatewayEncoding() const { return gatewayEncoding; }
+		//READY, GUILD_CREATE and GUILD_MEMBERS_CHUNK are read straight into their objects, without
+		//a document for their data. Only for JSON, and onDispatch gets null as d for these events
+		inline void setDirectEventParsing(bool enable) { directEventParsing = enable; }
+		inline bool hasDirectEventParsing() const { return directEventParsing; }
+
 		//time
 		template <class Handler, class... Types>
 		inline void setScheduleHandler(Types&&... arguments) {
@@ -527,6 +567,7 @@ namespace SleepyDiscord {
 
 		template<class Function>
 		void disconnectVoiceConnection_if(Function function) {
+			std::lock_guard<std::mutex> lock(voiceMutex);
 			auto i = std::find_if(voiceConnections.begin(), voiceConnections.end(), function);
 			if (i != voiceConnections.end())
 				disconnectVoiceConnection(*i);
@@ -557,6 +598,27 @@ namespace SleepyDiscord {
 		inline std::shared_ptr<ServerCache>& getServerCache() {
 			return serverCache;
 		}
+		//gateway events keep it up to date, so use it with the server cache
+		std::shared_ptr<PermissionCache> createPermissionCache();
+		inline void setPermissionCache(std::shared_ptr<PermissionCache> cache) {
+			permissionCache = cache;
+		}
+		inline std::shared_ptr<PermissionCache>& getPermissionCache() {
+			return permissionCache;
+		}
+		//saves the server cache and session, see CacheSnapshot
+		bool saveCacheSnapshot(const std::string& path);
+		//fills the server cache from a snapshot, making one if needed, and resumes its session
+		//Note: must be called before run or reconnect
+		bool loadCacheSnapshot(const std::string& path);
+		//keeps recent messages so that onEditCachedMessage and onDeleteCachedMessage are called
+		std::shared_ptr<MessageCache> createMessageCache(MessageCache::Settings settings = {});
+		inline void setMessageCache(std::shared_ptr<MessageCache> cache) {
+			messageCache = cache;
+		}
+		inline std::shared_ptr<MessageCache>& getMessageCache() {
+			return messageCache;
+		}
 
 	protected:
 		//Rest events
@@ -629,12 +691,20 @@ namespace SleepyDiscord {
 		virtual void onTyping            (Snowflake<Channel> channelID, Snowflake<User> userID, time_t timestamp);
 		virtual void onDeleteMessages    (Snowflake<Channel> channelID, std::vector<Snowflake<Message>> messages);
 		virtual void onEditMessage       (MessageRevisions   revisioins );
+		//these need a message cache, and are only called for messages that are in it
+		virtual void onEditCachedMessage (Message before, Message after) {}
+		virtual void onDeleteCachedMessage(Message            message    ) {}
 		virtual void onEditVoiceServer   (VoiceServerUpdate& update     );
 		virtual void onReaction          (Snowflake<User> userID, Snowflake<Channel> channelID, Snowflake<Message> messageID, Emoji emoji);
 		virtual void onDeleteReaction    (Snowflake<User> userID, Snowflake<Channel> channelID, Snowflake<Message> messageID, Emoji emoji);
 		virtual void onDeleteAllReaction (Snowflake<Server> serverID, Snowflake<Channel> channelID, Snowflake<Message> messageID);
 		virtual void onMessage           (Message            message    );
 		virtual void onServer            (Server             server     );
+		//the same events, but fields are only read from the event's json when they're used
+		//by default, these read everything and call the handlers above
+		virtual void onMessage           (const LazyMessage& message    );
+		virtual void onServer            (const LazyServer&  server     );
+		virtual void onPresenceUpdate    (const LazyPresenceUpdate& presenceUpdate);
 		virtual void onChannel           (Channel            channel    );
 		virtual void onInteraction       (Interaction        interaction) {}
 		virtual void onAppCommand        (AppCommand         appCommand ) {}
@@ -677,7 +747,10 @@ namespace SleepyDiscord {
 		}
 		void resetHeartbeatValues();
 		inline std::string getToken() { return *token.get(); }
-		inline void setToken(const std::string& value) { token = std::unique_ptr<std::string>(new std::string(value)); }
+		inline void setToken(const std::string& value) {
+			token = std::unique_ptr<std::string>(new std::string(value));
+			updateAuthHeaders();
+		}
 		void start(const std::string _token, const char maxNumOfThreads = DEFAULT_THREADS, int _shardID = 0, int _shardCount = 0);
 		inline void connect() {
 			postTask([this]() {
@@ -692,6 +765,10 @@ namespace SleepyDiscord {
 		) { return false; }
 		void handleFailToConnect() override { reconnect(); }
 		virtual void send(std::string /*message*/, WebsocketConnection& /*connection*/) {}
+		//websocket libraries that can't send binary messages will send them as text
+		virtual void sendBinary(std::string message, WebsocketConnection& connection) {
+			send(message, connection);
+		}
 		virtual void disconnect(unsigned int /*code*/, const std::string /*reason*/, WebsocketConnection& /*connection*/) {}
 		void reconnect(const unsigned int status = 4900);
 		virtual void stopClient() {}
@@ -717,6 +794,13 @@ namespace SleepyDiscord {
 		bool wasHeartbeatAcked = true;
 		std::unique_ptr<GenericScheduleHandler> scheduleHandler = nullptr;
 		Timer heart;
+		Timer cacheExpireTimer;
+		//calls the server cache's expire every so often, since TTL objects don't expire on their own
+		void startCacheExpiry();
+		void expireCache();
+		//removes this shard's servers that aren't in READY's list, like ones from a snapshot
+		//of a session that couldn't be resumed
+		void removeStaleServers(const std::list<UnavailableServer>& servers);
 
 		enum OPCode {
 			DISPATCH              = 0,  //dispatches an event
@@ -742,27 +826,64 @@ namespace SleepyDiscord {
 		Snowflake<User> userID;
 		void getTheGateway();
 		std::string theGateway;
-		bool ready = false;
+		//the session is changed on the gateway's strand, ready is also read from other threads
+		std::atomic<bool> ready{ false };
 		bool quiting = false;
 		bool bot = true;
+		std::string gatewayURL;
+		IdentifyHandler identifyHandler;
+		unsigned int identifyRequest = 0; //identifies for old connections are dropped
+		void identify();
 		void sendIdentity();
 		void sendResume();
 		void quit(bool isRestarting, bool isDisconnected = false);
 		void restart();
 		void disconnectWebsocket(unsigned int code, const std::string reason = "");
 		bool sendL(std::string message);    //the L stands for Limited
-		void handleDispatchEvent(const json::Value& t, json::Value& d);
+		void processFrame(FramePool::Lease frame);
+		void handleDispatchEvent(FramePool::Lease& frame);
 		int64_t nextHalfMin = 0;
 		std::mutex connectionMutex;
 		bool isCurrentlyWaitingToReconnect = false;
 		void stopReconnecting();
 
+		//gateway
+		FramePool framePool;
+		//events for the same server, or channel when there's no server, are handled in order
+		KeyedDispatcher<BaseDiscordClient> eventDispatcher{ *this };
+		static uint64_t getDispatchKey(const json::Value& t, const json::Value& d);
+
 		//Cache
 		std::shared_ptr<ServerCache> serverCache;
+		std::shared_ptr<MessageCache> messageCache;
+		std::shared_ptr<PermissionCache> permissionCache;
 
 		//rate limiting
 		int8_t messagesRemaining = 0;
-		RateLimiter<BaseDiscordClient> rateLimiter;
+		RateLimiter<BaseDiscordClient> rateLimiter{ *this };
+		friend RateLimiter<BaseDiscordClient>;
+		template<class Client> friend class ShardManager;
+
+		//http sessions
+		SessionPool sessionPool;
+		//Authorization and User-Agent are the same for every request, so they are only
+		//built when the token or bot changes. Use atomic_load and atomic_store to access
+		using AuthHeaders = std::shared_ptr<const std::vector<HeaderPair>>;
+		AuthHeaders authHeaders;
+		void updateAuthHeaders();
+#ifdef SLEEPY_CURL_MULTI
+		//lets async requests run on the io_service instead of blocking it
+		//needs to be destroyed before the session pool
+		std::unique_ptr<CurlMulti> curlMulti;
+		std::once_flag curlMultiFlag;
+		CurlMulti* getCurlMulti(); //nullptr when not using an ASIOBasedScheduleHandler
+#endif
+		Response performRequest(const RequestMethod method, const Route& path, const Route::Bucket& bucket,
+			const std::string& jsonParameters, const std::vector<Part>& multipartParameters,
+			const RequestCallback& callback, const RequestMode mode, const time_t currentTime);
+		void handleResponse(const RequestMethod method, const Route& path, const Route::Bucket& bucket,
+			const std::string& jsonParameters, const std::vector<Part>& multipartParameters,
+			const RequestCallback& callback, const RequestMode mode, Response& response);
 
 		//error handling
 		void setError(int errorCode);
@@ -776,7 +897,10 @@ namespace SleepyDiscord {
 		std::forward_list<VoiceConnection> voiceConnections;
 		std::forward_list<VoiceContext> voiceContexts;
 		std::forward_list<VoiceContext*> waitingVoiceContexts;
+		//events from different servers are handled at the same time, so the lists above need this
+		std::mutex voiceMutex;
 #ifdef SLEEPY_VOICE_ENABLED
+		//needs voiceMutex to be locked
 		void connectToVoiceIfReady(VoiceContext& context);
 		void removeVoiceConnectionAndContext(VoiceConnection& connection);
 #endif
@@ -784,6 +908,8 @@ namespace SleepyDiscord {
 		//compression
 		std::unique_ptr<GenericCompression> compressionHandler;
 		int8_t useTrasportConnection = static_cast<int8_t>(-1); //-1 for not set
+		GatewayEncoding gatewayEncoding = GatewayEncoding::JSON;
+		bool directEventParsing = false;
 
 		template<class Options, class Allocator>
 		typename std::enable_if<std::is_same<std::nullptr_t, std::remove_cv_t<Options>>::value, void>::type
@@ -822,21 +948,10 @@ namespace SleepyDiscord {
 			return json::stringify(doc);
 		}
 
-		template<class Callback>
-		void findServerInCache(Snowflake<Server>& serverID, Callback onSuccessCallback) {
-			if (serverCache) {
-				ServerCache::iterator server = serverCache->findServer(serverID);
-				if (server != static_cast<const ServerCache::iterator>(serverCache->end())) {
-					onSuccessCallback(server);
-				}
-			}
-		}
-
 		template<class Callback>
 		void accessServerFromCache(Snowflake<Server>& serverID, Callback callback) {
-			findServerInCache(serverID, [callback](ServerCache::iterator& found) {
-				callback(*found);
-			});
+			if (serverCache)
+				serverCache->accessServer(serverID, callback);
 		}
 
 		template<class Container, class Callback>
@@ -848,15 +963,11 @@ namespace SleepyDiscord {
 			});
 		}
 
-		template<class Container>
-		void appendObjectToCache(
-			Snowflake<Server>& serverID, Container Server::* container, typename Container::value_type& object
-		) {
-			accessContainerFromCache(serverID, container,
-				[object](Server&, Container& found) {
-					found.push_front(object);
-				}
-			);
+		template<class Object>
+		void appendObjectToCache(Snowflake<Server>& serverID, Object& object) {
+			accessServerFromCache(serverID, [this, object](Server& server) {
+				serverCache->cacheObject(server, object);
+			});
 		}
 
 		template<class Type, class Container, class Callback>
@@ -878,21 +989,18 @@ namespace SleepyDiscord {
 			Snowflake<Server> serverID, Container Server::* container, Type ID, Callback callback
 		) {
 			accessIteratorFromCache(serverID, container, ID,
-				[callback] (Server& server, typename Container::iterator& iterator) {
+				[this, callback, ID] (Server& server, typename Container::iterator& iterator) {
 					callback(server, *iterator);
+					serverCache->useObject(server, ID);
 				}
 			);
 		}
 
-		template<class Type, class Container>
-		void eraseObjectFromCache(
-			Snowflake<Server> serverID, Container Server::* container, Type ID
-		) {
-			accessIteratorFromCache(serverID, container, ID,
-				[container](Server& server, typename Container::iterator& found) {
-					(server.*(container)).erase(found);
-				}
-			);
+		template<class Type>
+		void eraseObjectFromCache(Snowflake<Server> serverID, Type ID) {
+			accessServerFromCache(serverID, [this, ID](Server& server) {
+				serverCache->uncacheObject(server, ID);
+			});
 		}
 
 		//The number 10 comes from the largest unsigned int being 10 digits long
@@ -73,7 +73,7 @@ namespace SleepyDiscord {
 				return false;
 			rapidjson::Document doc;
 			rapidjson::ParseResult isOK =
-				doc.Parse(text.c_str(), text.length());
+				json::parse(doc, text.data(), text.length(), text.capacity());
 			if (!isOK)
 				return false;
 			value = Type(doc);
@@ -90,14 +90,14 @@ namespace SleepyDiscord {
 		}
 		inline rapidjson::Document getDoc() {
 			rapidjson::Document arr; //ARR, I'm a pirate
-			arr.Parse(text.data(), text.length());
+			json::parse(arr, text.data(), text.length(), text.capacity());
 			return arr;
 		}
 		template<class Callback>
 		inline rapidjson::ParseResult getDoc(Callback& callback) {
 			rapidjson::Document arr;
 			rapidjson::ParseResult isOK =
-				arr.Parse(text.data(), text.length());
+				json::parse(arr, text.data(), text.length(), text.capacity());
 			if (isOK) callback(arr);
 			return isOK;
 		}
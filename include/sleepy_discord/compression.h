@@ -2,6 +2,8 @@
 
 #if defined(EXISTENT_ZLIB_NG) || defined(EXISTENT_ZLIB)
 #include "zlib_compression.h"
-#else
-#include "generic_compression.h"
-#endif // EXISTENT_ZLIB_NG
\ No newline at end of file
+#endif // EXISTENT_ZLIB_NG
+#ifdef EXISTENT_ZSTD
+#include "zstd_compression.h"
+#endif
+#include "generic_compression.h"
\ No newline at end of file
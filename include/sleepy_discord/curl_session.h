@@ -0,0 +1,110 @@
+#pragma once
+
+#if defined(SLEEPY_DISCORD_CMAKE)
+	#if defined(EXISTENT_CURL)
+		#include <curl/curl.h>
+	#elif !defined(NONEXISTENT_CURL)
+		#define NONEXISTENT_CURL
+	#endif
+#elif defined(SLEEPY_USE_CURL)
+	#include <curl/curl.h>
+#elif !defined(NONEXISTENT_CURL)
+	#define NONEXISTENT_CURL
+#endif
+
+#ifndef NONEXISTENT_CURL
+#include <memory>
+#include <unordered_map>
+#include "http.h"
+#include "asio_include.h"
+
+//curl gives us its sockets as file descriptors, so waiting on them with asio
+//needs posix descriptors
+#if !defined(NONEXISTENT_ASIO) && \
+	(defined(ASIO_HAS_POSIX_STREAM_DESCRIPTOR) || defined(BOOST_ASIO_HAS_POSIX_STREAM_DESCRIPTOR))
+	#define SLEEPY_CURL_MULTI
+#endif
+
+namespace SleepyDiscord {
+	class CurlSession;
+
+#ifdef SLEEPY_CURL_MULTI
+	//Does many curl requests at once on an io_service without blocking it
+	//Note: everything here, including response callbacks, happens on the io_service
+	//in a strand, since curl's multi isn't thread safe and the io_service can have many threads
+	class CurlMulti {
+	public:
+		CurlMulti(asio::io_service& service);
+		~CurlMulti();
+		CurlMulti(const CurlMulti&) = delete;
+		CurlMulti& operator=(const CurlMulti&) = delete;
+
+		//session needs to stay alive until its response callback is called
+		void add(CurlSession& session);
+		inline asio::io_service& getIOService() { return io; }
+
+	private:
+		struct Socket;
+
+		static int socketCallback(CURL* easy, curl_socket_t socket, int what, void* multiPtr, void* socketPtr);
+		static int timerCallback(CURLM* multi, long timeout, void* multiPtr);
+		void watch(const std::shared_ptr<Socket>& socket, const int direction);
+		void onEvent(curl_socket_t socket, int eventBitmask);
+		void checkFinished();
+
+		asio::io_service& io;
+		asio::io_service::strand strand;
+		CURLM* handle;
+		asio::steady_timer timer;
+		std::unordered_map<curl_socket_t, std::shared_ptr<Socket>> sockets;
+		std::unordered_map<CURL*, CurlSession*> transfers;
+	};
+#endif
+
+	class CurlSession : public GenericSession {
+	public:
+		CurlSession();
+		~CurlSession();
+		CurlSession(const CurlSession&) = delete;
+		CurlSession& operator=(const CurlSession&) = delete;
+
+		inline void setUrl(const std::string& url) {
+			curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+		}
+		//body isn't copied, it needs to stay alive until the response
+		void setBody(const std::string* jsonParameters);
+		void setHeader(const std::vector<HeaderPair>& header);
+		void setMultipart(const std::vector<Part>& parts);
+		inline void setResponseCallback(const ResponseCallback& callback) {
+			responseCallback = callback;
+		}
+		//returns right away when there's a multi and response callback
+		Response request(RequestMethod method);
+
+#ifdef SLEEPY_CURL_MULTI
+		inline void setMulti(CurlMulti* _multi) { multi = _multi; }
+#endif
+
+	private:
+		friend CurlMulti;
+		void prepare(RequestMethod method);
+		Response finish(CURLcode result); //may destroy the session if there's a callback
+		void cancel();
+		static std::size_t writeCallback(char* data, std::size_t size, std::size_t count, void* sessionPtr);
+		static std::size_t headerCallback(char* data, std::size_t size, std::size_t count, void* sessionPtr);
+
+		CURL* handle;
+		curl_slist* headerList = nullptr;
+		curl_mime* mime = nullptr;
+		const std::string* body = nullptr;
+		Response response;
+		ResponseCallback responseCallback;
+#ifdef SLEEPY_CURL_MULTI
+		CurlMulti* multi = nullptr;
+#endif
+	};
+
+	typedef CurlSession Session;
+}
+
+#endif
@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include "json_wrapper.h"
+
+namespace SleepyDiscord {
+	//Encoding of the payloads sent over the gateway
+	//ETF is smaller and cheaper to decode than JSON, since numbers and snowflakes are sent as binary
+	enum class GatewayEncoding : int8_t {
+		JSON = 0,
+		ETF  = 1,
+	};
+
+	//Erlang external term format, as used by Discord's gateway
+	//Terms are turned into json values, so that ETF and JSON payloads give the same events:
+	//maps become objects, lists and tuples become arrays, binaries become strings, the atoms
+	//nil, true and false become null and bools and other atoms become strings. Big integers,
+	//which Discord uses for snowflakes, become strings like they are in JSON.
+	namespace ETF {
+		enum Tag : unsigned char {
+			VERSION             = 131,
+			NEW_FLOAT_EXT       = 70,
+			SMALL_INTEGER_EXT   = 97,
+			INTEGER_EXT         = 98,
+			FLOAT_EXT           = 99,
+			ATOM_EXT            = 100,
+			SMALL_TUPLE_EXT     = 104,
+			LARGE_TUPLE_EXT     = 105,
+			NIL_EXT             = 106,
+			STRING_EXT          = 107,
+			LIST_EXT            = 108,
+			BINARY_EXT          = 109,
+			SMALL_BIG_EXT       = 110,
+			LARGE_BIG_EXT       = 111,
+			SMALL_ATOM_EXT      = 115,
+			MAP_EXT             = 116,
+			ATOM_UTF8_EXT       = 118,
+			SMALL_ATOM_UTF8_EXT = 119,
+		};
+
+		//returns false when data isn't a term that can be decoded
+		bool decode(const char* data, const std::size_t length,
+			json::Value& value, json::Value::AllocatorType& allocator);
+		//appends the term for value to out
+		void encode(const json::Value& value, std::string& out);
+		//turns a JSON payload into an ETF payload, returns false when json couldn't be parsed
+		bool encodeJSON(const std::string& json, std::string& out);
+	}
+}
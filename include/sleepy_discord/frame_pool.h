@@ -0,0 +1,114 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include "json_wrapper.h"
+
+namespace SleepyDiscord {
+	class FramePool;
+
+	//the data of an event that was read straight into its object instead of the document
+	struct ParsedEvent {
+		virtual ~ParsedEvent() = default;
+		uint64_t dispatchKey = 0;
+	};
+
+	template<class Object>
+	struct ParsedEventOf : public ParsedEvent {
+		ParsedEventOf(Object&& _object) : object(std::move(_object)) {}
+		Object object;
+	};
+
+	//A gateway message and the document parsed from it
+	//The document is parsed in place, so its strings point into text, and all of
+	//its memory comes from buffers that are kept between messages
+	class Frame {
+	public:
+		using Allocator = rapidjson::MemoryPoolAllocator<>;
+		using Document = rapidjson::GenericDocument<rapidjson::UTF8<>, Allocator, Allocator>;
+
+		Frame(const Frame&) = delete;
+		Frame& operator=(const Frame&) = delete;
+
+		std::string text; //the json to parse, it's changed by parse
+		std::unique_ptr<ParsedEvent> event; //when d isn't in the document
+
+		inline rapidjson::ParseResult parse() {
+			return json::parseInsitu(*document, text);
+		}
+		inline Document& getDocument() { return *document; }
+
+	private:
+		friend FramePool;
+		Frame(std::size_t valueCapacity, std::size_t stackCapacity);
+
+		void build(std::size_t valueCapacity, std::size_t stackCapacity);
+		//clears the frame for the next message, growing the buffers up to maxCapacity when
+		//the last message didn't fit in them
+		void recycle(std::size_t maxCapacity);
+
+		std::unique_ptr<char[]> valueBuffer;
+		std::unique_ptr<char[]> stackBuffer;
+		std::size_t valueCapacity = 0;
+		std::size_t stackCapacity = 0;
+		std::unique_ptr<Allocator> valueAllocator;
+		std::unique_ptr<Allocator> stackAllocator;
+		std::unique_ptr<Document> document;
+	};
+
+	//Reuses frames so that, once warmed up, parsing gateway messages doesn't allocate
+	class FramePool {
+	public:
+		struct Settings {
+			std::size_t maxIdleFrames = 16;          //extra frames are destroyed when returned
+			std::size_t maxFrameCapacity = 4 << 20;  //in bytes, buffers don't grow past this
+		};
+
+	private:
+		struct State;
+
+	public:
+		//Gives back the frame to the pool when destroyed
+		//Note: leases can't outlive their pool, use share for frames that might
+		struct Recycler {
+			State* state;
+			inline void operator()(Frame* frame) const { release(*state, frame); }
+		};
+		using Lease = std::unique_ptr<Frame, Recycler>;
+
+		FramePool() : state(std::make_shared<State>()) {}
+		FramePool(Settings _settings) : FramePool() { state->settings = _settings; }
+
+		Lease acquire();
+		//takes back a frame from Lease::release, used to pass frames through tasks
+		inline Lease adopt(Frame* frame) { return Lease(frame, Recycler{ state.get() }); }
+		//hands the frame over to a shared_ptr, which can outlive the pool. The frame goes back
+		//to the pool once it's not used, or is destroyed when the pool is already gone
+		std::shared_ptr<Frame> share(Lease lease);
+		std::size_t size(); //number of idle frames
+
+		inline void setSettings(const Settings& newSettings) {
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->settings = newSettings;
+		}
+		inline Settings getSettings() {
+			std::lock_guard<std::mutex> lock(state->mutex);
+			return state->settings;
+		}
+
+	private:
+		//shared frames keep a weak_ptr to this, so that they know if the pool is still there
+		struct State {
+			//frames that are leased are also owned here, so a task that never runs doesn't leak its frame
+			std::vector<std::unique_ptr<Frame>> frames;
+			std::vector<Frame*> idleFrames;
+			Settings settings;
+			std::mutex mutex;
+		};
+
+		static void release(State& state, Frame* frame);
+
+		std::shared_ptr<State> state;
+	};
+}
@@ -5,6 +5,7 @@
 #include "user.h"
 #include "channel.h"
 #include "server.h"
+#include "lazy_object.h"
 
 namespace SleepyDiscord {
 	struct SessionStartLimit : public DiscordObject {
@@ -35,7 +36,7 @@ namespace SleepyDiscord {
 			Gateway(json::fromJSON<Gateway>(json)) {}
 
 		std::string url;
-		int shards;
+		int shards = 0;
 		SessionStartLimit sessionStartLimit;
 
 		JSONStructStart
@@ -47,6 +48,30 @@ namespace SleepyDiscord {
 		JSONStructEnd
 	};
 
+	//What's needed to resume a gateway session, possibly from another process
+	struct GatewaySession : public DiscordObject {
+		GatewaySession() = default;
+		GatewaySession(const json::Value & rawJSON);
+		GatewaySession(const nonstd::string_view & json) :
+			GatewaySession(json::fromJSON<GatewaySession>(json)) {}
+
+		std::string sessionID;
+		int sequence = 0;
+		Snowflake<User> userID;
+		bool bot = true;
+
+		inline bool empty() const { return sessionID.empty(); }
+
+		JSONStructStart
+			std::make_tuple(
+				json::pair(&GatewaySession::sessionID, "session_id", json::OPTIONAL_FIELD),
+				json::pair(&GatewaySession::sequence , "seq"       , json::OPTIONAL_FIELD),
+				json::pair(&GatewaySession::userID   , "user_id"   , json::OPTIONAL_FIELD),
+				json::pair(&GatewaySession::bot      , "bot"       , json::OPTIONAL_FIELD)
+			);
+		JSONStructEnd
+	};
+
 	enum Status {
 		statusError = 0,
 		online         ,
@@ -287,6 +312,8 @@ namespace SleepyDiscord {
 		JSONStructEnd
 	};
 
+	using LazyPresenceUpdate = LazyObject<PresenceUpdate>;
+
 	struct ServerMembersChunk {
 		ServerMembersChunk() = default;
 		ServerMembersChunk(const json::Value& json);
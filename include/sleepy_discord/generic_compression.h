@@ -1,13 +1,63 @@
-#pragma once
-#include <string>
-
-namespace SleepyDiscord {
-	class GenericCompression {
-	public:
-		virtual ~GenericCompression() = default;
-		virtual void uncompress(const std::string& compressed) = 0;
-		virtual void getOutput(std::string& uncompressedOut) = 0;
-		virtual void resetStream() = 0;
-		virtual bool streamEnded() = 0;
-	};
+#pragma once
+#include <string>
+#include <algorithm>
+
+namespace SleepyDiscord {
+	class GenericCompression {
+	public:
+		virtual ~GenericCompression() = default;
+		virtual void uncompress(const std::string& compressed) = 0;
+		//when uncompressedOut is empty, implementations may swap their buffer with it instead
+		//of copying, so pass a string with memory that can be reused
+		virtual void getOutput(std::string& uncompressedOut) = 0;
+		virtual void resetStream() = 0;
+		virtual bool streamEnded() = 0;
+		//true when the last uncompress failed, the stream can't be used until it's reset
+		virtual bool hasFailed() { return false; }
+
+		//the value of compress in the gateway url when using transport compression
+		virtual const char* getTransportName() const {
+			return "zlib-stream";
+		}
+		//when using transport compression, checks if a websocket message is the last
+		//part of a gateway message. Discord ends those with the zlib flush signal
+		virtual bool isEndOfMessage(const std::string& compressed) const {
+			static constexpr char flushSignal[] = { 0, 0, '\xFF', '\xFF' };
+			constexpr std::size_t signalLength = sizeof(flushSignal);
+			return signalLength <= compressed.length() &&
+				compressed.compare(compressed.length() - signalLength, signalLength, flushSignal, signalLength) == 0;
+		}
+	};
+
+	//One contiguous buffer for uncompressed data that's handed over instead of copied
+	//only the first size bytes are data, the rest is room for uncompressing into
+	struct CompressionOutput {
+		std::string data;
+		std::size_t size = 0;
+		std::size_t expectedSize = 0; //recent output sizes, to reserve the buffer up front
+
+		//makes sure there's room after size, growing by doubling
+		inline void prepare() {
+			constexpr std::size_t minimumGrowth = 16 * 1024;
+			if (data.capacity() < expectedSize)
+				data.reserve(expectedSize);
+			if (size == data.size())
+				data.resize(data.size() + (std::max)(minimumGrowth, data.size()));
+		}
+		inline char* begin() { return &data[size]; }
+		inline std::size_t available() const { return data.size() - size; }
+
+		inline void moveTo(std::string& out) {
+			data.resize(size);
+			//large payloads are rare, so let the expected size slowly go back down after one
+			expectedSize = (std::max)(size, expectedSize - expectedSize / 8);
+			//hand over the buffer, and take the empty string's memory for next time
+			if (out.empty())
+				out.swap(data);
+			else
+				out.append(data);
+			data.clear();
+			size = 0;
+		}
+	};
 }
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include "asio_include.h"
+
+namespace SleepyDiscord {
+#ifndef NONEXISTENT_ASIO
+	//Runs an io_service on more than one thread
+	//Note: handlers can then run at the same time, so state that's used by more than one
+	//handler needs a strand
+	class IOThreadPool {
+	public:
+		struct Settings {
+			std::size_t threadCount = 1; //includes the thread that calls run
+			bool pinThreads = false;     //pins each thread to its own CPU
+			std::size_t firstCPU = 0;    //threads are pinned to firstCPU, firstCPU + 1, and so on
+		};
+
+		IOThreadPool() = default;
+		IOThreadPool(Settings _settings) : settings(_settings) {}
+
+		//blocks until the io_service stops
+		void run(asio::io_service& io);
+
+		inline void setSettings(const Settings& newSettings) {
+			std::lock_guard<std::mutex> lock(mutex);
+			settings = newSettings;
+		}
+		inline Settings getSettings() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return settings;
+		}
+
+		//pins the calling thread to a CPU, returns false when that isn't supported
+		static bool pinThread(std::size_t cpu);
+
+	private:
+		Settings settings;
+		std::mutex mutex;
+	};
+#endif
+}
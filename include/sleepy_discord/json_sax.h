@@ -0,0 +1,504 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "json_wrapper.h"
+#include "rapidjson/reader.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/encodedstream.h"
+
+namespace SleepyDiscord {
+	namespace json {
+		//Reads json straight into objects, without making a document first
+		//parseTokens sends the tokens to a stack of nodes, one for each object or array being
+		//read. Objects with a JSONStruct and containers of them are filled as the tokens
+		//come in, scalars go to the same type helpers as fromJSON, and any other object or array
+		//is read into a small value first. So the results are the same as fromJSON's.
+		//Note: this uses the field tables from fromJSON, so it needs c++14's constexpr
+#ifdef SLEEPY_ONE_PASS_FROM_JSON
+#define SLEEPY_SAX_FROM_JSON
+		namespace SAX {
+			class Parser;
+
+			class Node {
+			public:
+				virtual ~Node() = default;
+				//a scalar in the node, strings in value only last until this returns
+				virtual bool value(Parser& parser, Value& value) = 0;
+				virtual bool key(Parser& /*parser*/, const char* /*name*/, SizeType /*length*/) { return false; }
+				//an object or array in the node, the node pushes the node that reads it
+				virtual bool start(Parser& parser, bool isObject) = 0;
+				//the end of the node's object or array, the node calls finish once it's done
+				virtual bool end(Parser& parser, bool isObject, SizeType count) = 0;
+			};
+
+			//reads objects and arrays into a value, for the types that can't be filled directly
+			class ValueBuilder {
+			public:
+				inline void clear() {
+					values.clear();
+					starts.clear();
+					allocator.Clear();
+				}
+				inline void value(Value& value) {
+					if (value.IsString())
+						values.emplace_back(value.GetString(), value.GetStringLength(), allocator);
+					else
+						values.emplace_back(std::move(value));
+				}
+				inline void key(const char* name, SizeType length) {
+					values.emplace_back(name, length, allocator);
+				}
+				inline void start(bool isObject) {
+					starts.push_back(values.size());
+					values.emplace_back(isObject ? rapidjson::kObjectType : rapidjson::kArrayType);
+				}
+				void end(bool isObject) {
+					const std::size_t start = starts.back();
+					starts.pop_back();
+					Value& container = values[start];
+					if (isObject) {
+						container.MemberReserve(static_cast<SizeType>((values.size() - start - 1) / 2), allocator);
+						for (std::size_t i = start + 1; i + 1 < values.size(); i += 2)
+							container.AddMember(values[i], values[i + 1], allocator);
+					} else {
+						container.Reserve(static_cast<SizeType>(values.size() - start - 1), allocator);
+						for (std::size_t i = start + 1; i < values.size(); ++i)
+							container.PushBack(values[i], allocator);
+					}
+					values.resize(start + 1);
+				}
+				inline bool isDone() const { return starts.empty(); }
+				inline Value& getValue() { return values.front(); }
+
+			private:
+				Value::AllocatorType allocator;
+				std::vector<Value> values;
+				std::vector<std::size_t> starts;
+			};
+
+			//the handler given to parseTokens
+			class Parser {
+			public:
+				Parser(std::unique_ptr<Node> root) {
+					stack.push_back(std::move(root));
+				}
+
+				inline bool Null() { Value value; return scalar(value); }
+				inline bool Bool(bool boolean) { Value value(boolean); return scalar(value); }
+				inline bool Int(int number) { Value value(number); return scalar(value); }
+				inline bool Uint(unsigned number) { Value value(number); return scalar(value); }
+				inline bool Int64(int64_t number) { Value value(number); return scalar(value); }
+				inline bool Uint64(uint64_t number) { Value value(number); return scalar(value); }
+				inline bool Double(double number) { Value value(number); return scalar(value); }
+				inline bool RawNumber(const char* string, SizeType length, bool copy) {
+					return String(string, length, copy);
+				}
+				inline bool String(const char* string, SizeType length, bool copy) {
+					isCopy = copy;
+					Value value(rapidjson::StringRef(string, length));
+					return scalar(value);
+				}
+				inline bool Key(const char* name, SizeType length, bool copy) {
+					isCopy = copy;
+					return stack.back()->key(*this, name, length);
+				}
+				inline bool StartObject() { return stack.back()->start(*this, true); }
+				inline bool EndObject(SizeType count) { return end(true, count); }
+				inline bool StartArray() { return stack.back()->start(*this, false); }
+				inline bool EndArray(SizeType count) { return end(false, count); }
+
+				inline void push(std::unique_ptr<Node> node) { stack.push_back(std::move(node)); }
+				//pops the node at the top once it returns from end
+				inline void finish() { isFinished = true; }
+				//if the last string or key goes away after the handler returns
+				inline bool isStringCopied() const { return isCopy; }
+				//there's only ever one value being built, since those nodes don't push any others
+				inline ValueBuilder& getBuilder() { return builder; }
+
+			private:
+				inline bool scalar(Value& value) {
+					return stack.back()->value(*this, value);
+				}
+				bool end(bool isObject, SizeType count) {
+					const bool isOK = stack.back()->end(*this, isObject, count);
+					if (isFinished) {
+						isFinished = false;
+						stack.pop_back();
+					}
+					return isOK;
+				}
+
+				std::vector<std::unique_ptr<Node>> stack;
+				ValueBuilder builder;
+				bool isFinished = false;
+				bool isCopy = false;
+			};
+
+			//sends a scalar to another handler, like a document
+			template<class Handler>
+			bool forward(Handler& handler, const Value& value, bool copy) {
+				switch (value.GetType()) {
+				case rapidjson::kNullType: return handler.Null();
+				case rapidjson::kFalseType: return handler.Bool(false);
+				case rapidjson::kTrueType: return handler.Bool(true);
+				case rapidjson::kStringType: return handler.String(value.GetString(), value.GetStringLength(), copy);
+				case rapidjson::kNumberType:
+					if (value.IsInt()) return handler.Int(value.GetInt());
+					if (value.IsUint()) return handler.Uint(value.GetUint());
+					if (value.IsInt64()) return handler.Int64(value.GetInt64());
+					if (value.IsUint64()) return handler.Uint64(value.GetUint64());
+					return handler.Double(value.GetDouble());
+				default: return false;
+				}
+			}
+
+			//skips over unknown fields
+			class SkipNode : public Node {
+			public:
+				bool value(Parser&, Value&) override { return true; }
+				bool key(Parser&, const char*, SizeType) override { return true; }
+				bool start(Parser&, bool) override {
+					++depth;
+					return true;
+				}
+				bool end(Parser& parser, bool, SizeType) override {
+					if (--depth == 0)
+						parser.finish();
+					return true;
+				}
+			private:
+				std::size_t depth = 1;
+			};
+
+			//reads the value into the parser's builder, and gives it to the receiver
+			template<class Receiver>
+			class BuildNode : public Node {
+			public:
+				BuildNode(Parser& parser, bool isObject, Receiver _receiver) :
+					receiver(std::move(_receiver))
+				{
+					parser.getBuilder().clear();
+					parser.getBuilder().start(isObject);
+				}
+				bool value(Parser& parser, Value& value) override {
+					parser.getBuilder().value(value);
+					return true;
+				}
+				bool key(Parser& parser, const char* name, SizeType length) override {
+					parser.getBuilder().key(name, length);
+					return true;
+				}
+				bool start(Parser& parser, bool isObject) override {
+					parser.getBuilder().start(isObject);
+					return true;
+				}
+				bool end(Parser& parser, bool isObject, SizeType) override {
+					ValueBuilder& builder = parser.getBuilder();
+					builder.end(isObject);
+					if (builder.isDone()) {
+						receiver.receive(builder.getValue());
+						parser.finish();
+					}
+					return true;
+				}
+			private:
+				Receiver receiver;
+			};
+
+			//objects that can be filled field by field, like fromJSON does
+			template<class Object, class Enable = void>
+			struct IsDirect : public std::false_type {};
+
+			template<class Object>
+			struct IsDirect<Object, typename std::conditional<true, void, decltype(Object::JSONStruct)>::type> : public std::integral_constant<bool,
+				!hasIsType<Object>::value && std::is_default_constructible<Object>::value
+			> {};
+
+			template<class Receiver>
+			inline bool startBuild(Parser& parser, bool isObject, Receiver receiver) {
+				parser.push(std::unique_ptr<Node>(new BuildNode<Receiver>(parser, isObject, std::move(receiver))));
+				return true;
+			}
+
+			//starts the node for an object or array read by Helper
+			template<class Helper>
+			struct Start {
+				template<class Receiver>
+				static inline bool start(Parser& parser, bool isObject, Receiver receiver) {
+					return startBuild(parser, isObject, std::move(receiver));
+				}
+			};
+
+			template<class Object, class Receiver>
+			class ObjectNode;
+
+			template<class Container, class Helper, class Receiver>
+			class ArrayNode;
+
+			template<class Type>
+			struct Start<ClassTypeHelper<Type>> {
+				template<class Receiver>
+				static inline bool start(Parser& parser, bool isObject, Receiver receiver) {
+					return start(parser, isObject, std::move(receiver), IsDirect<Type>());
+				}
+
+				template<class Receiver>
+				static inline bool start(Parser& parser, bool isObject, Receiver receiver, std::true_type) {
+					if (!isObject)
+						return startBuild(parser, isObject, std::move(receiver));
+					parser.push(std::unique_ptr<Node>(new ObjectNode<Type, Receiver>(std::move(receiver))));
+					return true;
+				}
+
+				template<class Receiver>
+				static inline bool start(Parser& parser, bool isObject, Receiver receiver, std::false_type) {
+					return startBuild(parser, isObject, std::move(receiver));
+				}
+			};
+
+			template<class Container, template<class...> class TypeHelper>
+			struct Start<ContainerTypeHelper<Container, TypeHelper>> {
+				template<class Receiver>
+				static inline bool start(Parser& parser, bool isObject, Receiver receiver) {
+					if (isObject)
+						return startBuild(parser, isObject, std::move(receiver));
+					using Helper = TypeHelper<typename Container::value_type>;
+					parser.push(std::unique_ptr<Node>(new ArrayNode<Container, Helper, Receiver>(std::move(receiver))));
+					return true;
+				}
+			};
+
+			//gives the receiver the object in a wrapper, like a pointer or optional
+			template<class Wrapper, class Receiver>
+			struct WrapReceiver {
+				Receiver receiver;
+				template<class Type>
+				inline void receive(Type&& object) {
+					receiver.receive(Wrapper::wrap(std::forward<Type>(object)));
+				}
+				//values are read by the helper of the wrapper
+				inline void receive(Value& value) {
+					receiver.receive(value);
+				}
+			};
+
+			template<class Wrapped, template<class...> class TypeHelper, class Element>
+			struct Wrap {
+				template<class Receiver>
+				static inline bool start(Parser& parser, bool isObject, Receiver receiver) {
+					return Start<TypeHelper<Element>>::start(parser, isObject,
+						WrapReceiver<Wrapped, Receiver>{ std::move(receiver) });
+				}
+			};
+
+			template<class SmartPtr>
+			struct PointerWrapper {
+				template<class Type>
+				static inline SmartPtr wrap(Type&& object) {
+					return SmartPtr{ new typename SmartPtr::element_type{ std::forward<Type>(object) } };
+				}
+			};
+
+			template<class Optional>
+			struct OptionalWrapper {
+				template<class Type>
+				static inline Optional wrap(Type&& object) {
+					return Optional{ std::forward<Type>(object) };
+				}
+			};
+
+			template<class SmartPtr, template<class...> class TypeHelper>
+			struct Start<SmartPtrTypeHelper<SmartPtr, TypeHelper>> :
+				public Wrap<PointerWrapper<SmartPtr>, TypeHelper, typename SmartPtr::element_type> {};
+
+			template<class Optional, template<class...> class TypeHelper>
+			struct Start<OptionalTypeHelper<Optional, TypeHelper>> :
+				public Wrap<OptionalWrapper<Optional>, TypeHelper, typename Optional::value_type> {};
+
+			template<class Nullable, template<class...> class TypeHelper>
+			struct Start<NullableTypeHelper<Nullable, TypeHelper>> :
+				public Wrap<OptionalWrapper<Nullable>, TypeHelper, typename Nullable::value_type> {};
+
+			//sets a field of an object
+			template<class Object, std::size_t i>
+			struct FieldReceiver {
+				Object* object;
+				template<class Type>
+				inline void receive(Type&& value) {
+					(*object).*(std::get<i>(Object::JSONStruct).member) = std::forward<Type>(value);
+				}
+				inline void receive(Value& value) {
+					FieldTable::setField<Object, Value, i>(*object, value);
+				}
+			};
+
+			//adds to the end of a container
+			template<class Container, class Helper>
+			struct ElementReceiver {
+				Container* container;
+				template<class Type>
+				inline void receive(Type&& value) {
+					container->push_back(std::forward<Type>(value));
+				}
+				inline void receive(Value& value) {
+					container->push_back(Helper::toType(value));
+				}
+			};
+
+			template<class Object, std::size_t i>
+			bool startField(Parser& parser, Object& object, bool isObject) {
+				using Helper = typename std::decay<decltype(std::get<i>(Object::JSONStruct))>::type::Helper;
+				return Start<Helper>::start(parser, isObject, FieldReceiver<Object, i>{ &object });
+			}
+
+			template<class Object, std::size_t... i>
+			inline bool startField(const std::size_t index, Parser& parser, Object& object, bool isObject, std::index_sequence<i...>) {
+				using Starter = bool (*)(Parser&, Object&, bool);
+				static constexpr Starter starters[] = { &startField<Object, i>..., nullptr };
+				return starters[index](parser, object, isObject);
+			}
+
+			template<class Object, class Receiver>
+			class ObjectNode : public Node {
+			public:
+				using Fields = FieldTable::Of<Object>;
+				static constexpr std::size_t fieldCount = Fields::fieldCount;
+
+				ObjectNode(Receiver _receiver) : receiver(std::move(_receiver)) {}
+
+				bool key(Parser&, const char* name, SizeType length) override {
+					field = Fields::find(name, length);
+					//like FindMember, only the first member with the name is used
+					if (field != fieldCount) {
+						if (isFound[field])
+							field = fieldCount;
+						else
+							isFound[field] = true;
+					}
+					return true;
+				}
+				bool value(Parser&, Value& value) override {
+					if (field != fieldCount)
+						FieldTable::setField(field, object, value, std::make_index_sequence<fieldCount>());
+					return true;
+				}
+				bool start(Parser& parser, bool isObject) override {
+					if (field == fieldCount) {
+						parser.push(std::unique_ptr<Node>(new SkipNode));
+						return true;
+					}
+					return startField(field, parser, object, isObject, std::make_index_sequence<fieldCount>());
+				}
+				bool end(Parser& parser, bool, SizeType) override {
+					for (std::size_t i = 0; i < fieldCount; ++i) {
+						if (isFound[i] || Fields::table.types[i] != REQUIRIED_FIELD)
+							continue;
+						//error
+						std::cout <<
+						"JSON Parse Error: "
+						"variable #" << i << ": \"" << Fields::table.names[i] << "\" not found. "
+						"Please look at call stack from your debugger for more details.";
+					}
+					AfterFromJSON<Object>::apply(object);
+					receiver.receive(std::move(object));
+					parser.finish();
+					return true;
+				}
+
+			private:
+				Receiver receiver;
+				Object object;
+				bool isFound[fieldCount + 1] = {};
+				std::size_t field = fieldCount; //the field of the next value, fieldCount to skip it
+			};
+
+			template<class Container, class Helper, class Receiver>
+			class ArrayNode : public Node {
+			public:
+				ArrayNode(Receiver _receiver) : receiver(std::move(_receiver)) {}
+
+				bool value(Parser&, Value& value) override {
+					ElementReceiver<Container, Helper>{ &container }.receive(value);
+					return true;
+				}
+				bool start(Parser& parser, bool isObject) override {
+					return Start<Helper>::start(parser, isObject, ElementReceiver<Container, Helper>{ &container });
+				}
+				bool end(Parser& parser, bool, SizeType) override {
+					receiver.receive(std::move(container));
+					parser.finish();
+					return true;
+				}
+
+			private:
+				Receiver receiver;
+				Container container;
+			};
+
+			template<class Object>
+			struct ResultReceiver {
+				Object* object;
+				bool* isRead;
+				inline void receive(Object&& result) {
+					*object = std::move(result);
+					*isRead = true;
+				}
+				inline void receive(Value&) {}
+			};
+
+			//the top of the json, only an object is read into Object
+			template<class Object>
+			class RootNode : public Node {
+			public:
+				RootNode(Object& _object, bool& _isRead) : object(&_object), isRead(&_isRead) {}
+				bool value(Parser&, Value&) override { return false; }
+				bool start(Parser& parser, bool isObject) override {
+					if (!isObject)
+						return false;
+					parser.push(std::unique_ptr<Node>(new ObjectNode<Object, ResultReceiver<Object>>(
+						ResultReceiver<Object>{ object, isRead })));
+					return true;
+				}
+				bool end(Parser&, bool, SizeType) override { return false; }
+			private:
+				Object* object;
+				bool* isRead;
+			};
+
+			//parse sends the tokens to the parser it's given
+			template<class Object, class Parse>
+			rapidjson::ParseResult readInto(Object& object, Parse parse) {
+				bool isRead = false;
+				Parser parser(std::unique_ptr<Node>(new RootNode<Object>(object, isRead)));
+				rapidjson::ParseResult result = parse(parser);
+				if (result && !isRead)
+					result.Set(rapidjson::kParseErrorValueInvalid);
+				return result;
+			}
+
+			template<unsigned parseFlags, class Object, class Stream>
+			rapidjson::ParseResult fromJSON(Object& object, Stream& stream) {
+				return readInto(object, [&stream](Parser& parser) {
+					rapidjson::Reader reader;
+					return reader.Parse<parseFlags>(stream, parser);
+				});
+			}
+
+			//like json::fromJSON, without the document
+			template<class Object>
+			inline rapidjson::ParseResult fromJSON(Object& object, const nonstd::string_view& json) {
+				return readInto(object, [&json](Parser& parser) {
+					return parseTokens(parser, json.data(), json.length());
+				});
+			}
+
+			//json is changed, and strings are only copied once into the object
+			template<class Object>
+			inline rapidjson::ParseResult fromJSONInsitu(Object& object, char* json) {
+				rapidjson::InsituStringStream stream(json);
+				return fromJSON<rapidjson::kParseInsituFlag>(object, stream);
+			}
+		}
+#endif
+	}
+}
@@ -6,6 +6,9 @@
 #include <tuple>
 #include <memory>
 #include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 //for errrors
 #include <iostream>
 #include "nonstd/optional.hpp"
@@ -702,16 +705,17 @@ namespace SleepyDiscord {
 			return true;
 		}
 
+		//reads the fields one at a time, looking each one up with FindMember
 		template<FromJSONMode mode = FromJSONMode::Default, class ResultingObject, class Value, size_t i = 0>
 		inline typename std::enable_if<i == std::tuple_size<decltype(ResultingObject::JSONStruct)>::value, bool>::type
-			fromJSON(ResultingObject&, Value&)
+			fromJSONByField(ResultingObject&, Value&)
 		{
 			return true;
 		}
 
 		template<FromJSONMode mode = FromJSONMode::Default, class ResultingObject, class Value, size_t i = 0>
 		inline typename std::enable_if<i < std::tuple_size<decltype(ResultingObject::JSONStruct)>::value, bool>::type
-			fromJSON(ResultingObject& object, Value& value)
+			fromJSONByField(ResultingObject& object, Value& value)
 		{
 			constexpr auto field = std::get<i>(ResultingObject::JSONStruct);
 			using Helper = typename decltype(field)::Helper;
@@ -733,20 +737,299 @@ namespace SleepyDiscord {
 				if (mode == FromJSONMode::ReturnOnError)
 					return false;
 			}
-			return fromJSON<mode, ResultingObject, Value, i + 1>(object, value);
+			return fromJSONByField<mode, ResultingObject, Value, i + 1>(object, value);
 		}
 
+		//FindMember compares the name with every member of the object, so objects with
+		//a lot of fields, like servers, compare a lot of strings. When the compiler allows
+		//loops in constexpr functions, fromJSON goes over the members of the object once
+		//instead, and finds their fields in a perfect hash table made at compile time from
+		//the names in JSONStruct.
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304 && defined(__cpp_lib_integer_sequence)
+#define SLEEPY_ONE_PASS_FROM_JSON
+		namespace FieldTable {
+			constexpr uint32_t hash(const char* name, const std::size_t length, const uint32_t seed) {
+				uint32_t result = 2166136261u ^ seed;
+				for (std::size_t i = 0; i < length; ++i)
+					result = (result ^ static_cast<unsigned char>(name[i])) * 16777619u;
+				return result ^ (result >> 15);
+			}
+
+			constexpr std::size_t getSlotCount(const std::size_t fieldCount) {
+				//sparse enough that a seed without collisions is found after a few tries
+				std::size_t count = 1;
+				while (count < fieldCount * 8)
+					count <<= 1;
+				return count;
+			}
+
+			//arrays have one more element than there are fields, so that they're never empty
+			template<std::size_t fieldCount>
+			struct Table {
+				static constexpr std::size_t slotCount = getSlotCount(fieldCount);
+				static constexpr uint32_t maxSeed = 4096;
+				const char* names[fieldCount + 1] = {};
+				std::size_t lengths[fieldCount + 1] = {};
+				FieldType types[fieldCount + 1] = {};
+				uint8_t slots[slotCount] = {}; //index of the field + 1, or 0 for none
+				uint32_t seed = 0;
+				bool isPerfect = false;
+			};
+
+			template<class Object, std::size_t... i>
+			constexpr Table<sizeof...(i)> make(std::index_sequence<i...>) {
+				constexpr std::size_t fieldCount = sizeof...(i);
+				Table<fieldCount> table;
+				const char* names[fieldCount + 1] = { std::get<i>(Object::JSONStruct).name..., nullptr };
+				const FieldType types[fieldCount + 1] = { std::get<i>(Object::JSONStruct).type..., REQUIRIED_FIELD };
+				for (std::size_t field = 0; field < fieldCount; ++field) {
+					table.names[field] = names[field];
+					table.types[field] = types[field];
+					std::size_t length = 0;
+					while (names[field][length] != '\0')
+						++length;
+					table.lengths[field] = length;
+				}
+				if (fieldCount == 0 || 255 <= fieldCount)
+					return table;
+				for (uint32_t seed = 0; seed < Table<fieldCount>::maxSeed; ++seed) {
+					for (std::size_t slot = 0; slot < Table<fieldCount>::slotCount; ++slot)
+						table.slots[slot] = 0;
+					bool hasCollision = false;
+					for (std::size_t field = 0; field < fieldCount && !hasCollision; ++field) {
+						const std::size_t slot = hash(table.names[field], table.lengths[field], seed) &
+							(Table<fieldCount>::slotCount - 1);
+						hasCollision = table.slots[slot] != 0;
+						table.slots[slot] = static_cast<uint8_t>(field + 1);
+					}
+					if (!hasCollision) {
+						table.seed = seed;
+						table.isPerfect = true;
+						return table;
+					}
+				}
+				return table;
+			}
+
+			template<class Object>
+			struct Of {
+				static constexpr std::size_t fieldCount = std::tuple_size<decltype(Object::JSONStruct)>::value;
+				static constexpr Table<fieldCount> table = make<Object>(std::make_index_sequence<fieldCount>());
+
+				//the index of the field with the name, or fieldCount if there's none
+				static inline std::size_t find(const char* name, const std::size_t length) {
+					if (!table.isPerfect) {
+						for (std::size_t field = 0; field < fieldCount; ++field) {
+							if (table.lengths[field] == length && std::memcmp(table.names[field], name, length) == 0)
+								return field;
+						}
+						return fieldCount;
+					}
+					const std::size_t slot = hash(name, length, table.seed) & (Table<fieldCount>::slotCount - 1);
+					const std::size_t index = table.slots[slot];
+					if (index == 0)
+						return fieldCount;
+					const std::size_t field = index - 1;
+					if (table.lengths[field] != length || std::memcmp(table.names[field], name, length) != 0)
+						return fieldCount;
+					return field;
+				}
+			};
+
+			template<class Object>
+			constexpr Table<Of<Object>::fieldCount> Of<Object>::table;
+
+			template<class ResultingObject, class Value, std::size_t i>
+			bool setField(ResultingObject& object, Value& value) {
+				constexpr auto field = std::get<i>(ResultingObject::JSONStruct);
+				using Helper = typename decltype(field)::Helper;
+				if (castValue<Helper>(object.*(field.member), value))
+					return true;
+				return field.type != REQUIRIED_FIELD && value.IsNull();
+			}
+
+			template<class ResultingObject, class Value, std::size_t... i>
+			inline bool setField(const std::size_t index, ResultingObject& object, Value& value, std::index_sequence<i...>) {
+				using Setter = bool (*)(ResultingObject&, Value&);
+				static constexpr Setter setters[] = { &setField<ResultingObject, Value, i>..., nullptr };
+				return setters[index](object, value);
+			}
+		}
+
+		template<FromJSONMode mode = FromJSONMode::Default, class ResultingObject, class Value>
+		inline bool fromJSONInOnePass(ResultingObject& object, Value& value) {
+			using Fields = FieldTable::Of<ResultingObject>;
+			constexpr std::size_t fieldCount = Fields::fieldCount;
+			bool isFound[fieldCount + 1] = {};
+			if (value.IsObject()) {
+				for (auto member = value.MemberBegin(); member != value.MemberEnd(); ++member) {
+					const std::size_t field = Fields::find(member->name.GetString(), member->name.GetStringLength());
+					//like FindMember, only the first member with the name is used
+					if (field == fieldCount || isFound[field])
+						continue;
+					isFound[field] = true;
+					if (!FieldTable::setField(field, object, member->value, std::make_index_sequence<fieldCount>()) &&
+						mode == FromJSONMode::ReturnOnError)
+						return false;
+				}
+			}
+			for (std::size_t field = 0; field < fieldCount; ++field) {
+				if (isFound[field] || Fields::table.types[field] != REQUIRIED_FIELD)
+					continue;
+				//error
+				std::cout <<
+				"JSON Parse Error: "
+				"variable #" << field << ": \"" << Fields::table.names[field] << "\" not found. "
+				"Please look at call stack from your debugger for more details.";
+				if (mode == FromJSONMode::ReturnOnError)
+					return false;
+			}
+			return true;
+		}
+#endif
+
+		template<FromJSONMode mode = FromJSONMode::Default, class ResultingObject, class Value>
+		inline bool fromJSON(ResultingObject& object, Value& value) {
+#ifdef SLEEPY_ONE_PASS_FROM_JSON
+			if (FieldTable::Of<ResultingObject>::table.isPerfect)
+				return fromJSONInOnePass<mode>(object, value);
+#endif
+			return fromJSONByField<mode>(object, value);
+		}
+
+		//for objects that need more than their fields once they're read, like an id copied
+		//from a nested object
+		template<class Object>
+		struct AfterFromJSON {
+			static inline void apply(Object&) {}
+		};
+
 		template<class ResultingObject, class Value>
 		inline ResultingObject fromJSON(Value& value) {
 			ResultingObject object;
 			fromJSON(object, value);
+			AfterFromJSON<ResultingObject>::apply(object);
 			return object;
 		}
 
+		//The parser for json text is picked with SLEEPY_JSON_BACKEND when building the library.
+		//It's rapidjson's own reader by default. With simdjson, its tokens are sent to the
+		//same rapidjson handlers, so documents, and everything read from them, stay the same
+		//simdjson is only used for json that can't be parsed in place, since rapidjson in place
+		//doesn't copy strings, which is faster for gateway messages. See examples/json-benchmark
+#ifdef EXISTENT_SIMDJSON
+		namespace Backend {
+			//simdjson may read this many bytes past the end of the json, having them in the
+			//buffer's capacity saves copying the json into a buffer that has them
+			constexpr std::size_t padding = 64;
+
+			//strings given to the handler are gone once it returns, so they're always copied
+			struct Handler {
+				virtual ~Handler() = default;
+				virtual bool Null() = 0;
+				virtual bool Bool(bool boolean) = 0;
+				virtual bool Int(int number) = 0;
+				virtual bool Uint(unsigned number) = 0;
+				virtual bool Int64(int64_t number) = 0;
+				virtual bool Uint64(uint64_t number) = 0;
+				virtual bool Double(double number) = 0;
+				virtual bool String(const char* string, SizeType length) = 0;
+				virtual bool StartObject() = 0;
+				virtual bool Key(const char* name, SizeType length) = 0;
+				virtual bool EndObject(SizeType count) = 0;
+				virtual bool StartArray() = 0;
+				virtual bool EndArray(SizeType count) = 0;
+			};
+
+			template<class Target>
+			struct HandlerOf : public Handler {
+				HandlerOf(Target& _target) : target(_target) {}
+				bool Null() override { return target.Null(); }
+				bool Bool(bool boolean) override { return target.Bool(boolean); }
+				bool Int(int number) override { return target.Int(number); }
+				bool Uint(unsigned number) override { return target.Uint(number); }
+				bool Int64(int64_t number) override { return target.Int64(number); }
+				bool Uint64(uint64_t number) override { return target.Uint64(number); }
+				bool Double(double number) override { return target.Double(number); }
+				bool String(const char* string, SizeType length) override {
+					return target.String(string, length, true);
+				}
+				bool StartObject() override { return target.StartObject(); }
+				bool Key(const char* name, SizeType length) override {
+					return target.Key(name, length, true);
+				}
+				bool EndObject(SizeType count) override { return target.EndObject(count); }
+				bool StartArray() override { return target.StartArray(); }
+				bool EndArray(SizeType count) override { return target.EndArray(count); }
+				Target& target;
+			};
+
+			//capacity is how much of the buffer at json can be read
+			rapidjson::ParseResult parse(Handler& handler, const char* json, std::size_t length, std::size_t capacity);
+		}
+#else
+		namespace Backend {
+			constexpr std::size_t padding = 0;
+		}
+#endif
+
+		//sends the tokens in the json to a rapidjson handler
+		template<class Handler>
+		inline rapidjson::ParseResult parseTokens(Handler& handler, const char* json, std::size_t length,
+			std::size_t capacity = 0
+		) {
+#ifdef EXISTENT_SIMDJSON
+			Backend::HandlerOf<Handler> backendHandler(handler);
+			return Backend::parse(backendHandler, json, length, capacity);
+#else
+			(void)capacity;
+			rapidjson::MemoryStream memory(json, length);
+			rapidjson::EncodedInputStream<rapidjson::UTF8<>, rapidjson::MemoryStream> stream(memory);
+			rapidjson::Reader reader;
+			return reader.Parse(stream, handler);
+#endif
+		}
+
+		//like parseTokens, but the json may be changed to save copying strings out of it
+		template<class Handler>
+		inline rapidjson::ParseResult parseTokensInsitu(Handler& handler, std::string& json) {
+			rapidjson::InsituStringStream stream(&json[0]);
+			rapidjson::Reader reader;
+			return reader.Parse<rapidjson::kParseInsituFlag>(stream, handler);
+		}
+
+		//parses json into a document, the document is left null when there's an error
+		template<class Encoding, class Allocator, class StackAllocator>
+		inline rapidjson::ParseResult parse(rapidjson::GenericDocument<Encoding, Allocator, StackAllocator>& document,
+			const char* json, std::size_t length, std::size_t capacity = 0
+		) {
+#ifdef EXISTENT_SIMDJSON
+			rapidjson::ParseResult result;
+			auto generator = [&](rapidjson::GenericDocument<Encoding, Allocator, StackAllocator>& handler) {
+				result = parseTokens(handler, json, length, capacity);
+				return !result.IsError();
+			};
+			document.SetNull();
+			document.Populate(generator);
+			return result;
+#else
+			(void)capacity;
+			return document.Parse(json, length);
+#endif
+		}
+
+		//like parse, but the json may be changed to save copying strings out of it
+		template<class Encoding, class Allocator, class StackAllocator>
+		inline rapidjson::ParseResult parseInsitu(rapidjson::GenericDocument<Encoding, Allocator, StackAllocator>& document,
+			std::string& json
+		) {
+			return document.ParseInsitu(&json[0]);
+		}
+
 		template<class ResultingObject>
 		inline rapidjson::ParseResult fromJSON(ResultingObject& obj, const nonstd::string_view& json) {
 			rapidjson::Document doc;
-			rapidjson::ParseResult isOK = doc.Parse(json.data(), json.length());
+			rapidjson::ParseResult isOK = parse(doc, json.data(), json.length());
 			if (isOK)
 				obj = ResultingObject{doc};
 			return isOK;
@@ -754,7 +1037,7 @@ namespace SleepyDiscord {
 
 		inline rapidjson::Document parse(const nonstd::string_view& json) {
 			rapidjson::Document doc;
-			doc.Parse(json.data(), json.length());
+			parse(doc, json.data(), json.length());
 			return doc;
 		}
 
@@ -807,17 +1090,171 @@ namespace SleepyDiscord {
 			return doc;
 		}
 
-		inline std::string stringify(const Value& value) {
+		//Writes objects straight into a rapidjson::Writer, without making a value of them first
+		//Objects with a JSONStruct, and containers, pointers and optionals of them, are written
+		//field by field. Everything else goes through its helper's fromType, like in toJSON, so
+		//the output is the same.
+		template<class Helper>
+		struct WriteValue {
+			template<class Writer, class Type>
+			static inline bool write(Writer& writer, const Type& value, Value::AllocatorType& allocator) {
+				return Helper::fromType(value, allocator).Accept(writer);
+			}
+		};
+
+		template<class Writer, class Object>
+		inline bool writeJSON(Writer& writer, const Object& object, Value::AllocatorType& allocator);
+
+		template<class Object>
+		struct hasJSONStruct {
+		private:
+			template<typename T>
+			static constexpr auto check(T*)
+			-> decltype(std::tuple_size<decltype(T::JSONStruct)>::value, std::true_type());
+
+			template<typename>
+			static constexpr std::false_type check(...);
+
+		public:
+			using type = decltype(check<Object>(0));
+			static constexpr bool value = type::value;
+		};
+
+		template<class Type>
+		struct WriteValue<ClassTypeHelper<Type>> {
+			//the same objects that ClassTypeHelper gives to toJSON
+			using isObject = std::integral_constant<bool, hasJSONStruct<Type>::value && !hasSerialize<Type>::value>;
+
+			template<class Writer>
+			static inline bool write(Writer& writer, const Type& value, Value::AllocatorType& allocator) {
+				return write(writer, value, allocator, isObject());
+			}
+			template<class Writer>
+			static inline bool write(Writer& writer, const Type& value, Value::AllocatorType& allocator, std::true_type) {
+				return writeJSON(writer, value, allocator);
+			}
+			template<class Writer>
+			static inline bool write(Writer& writer, const Type& value, Value::AllocatorType& allocator, std::false_type) {
+				return ClassTypeHelper<Type>::fromType(value, allocator).Accept(writer);
+			}
+		};
+
+		template<class Container, template<class...> class TypeHelper>
+		struct WriteArray {
+			template<class Writer>
+			static inline bool write(Writer& writer, const Container& values, Value::AllocatorType& allocator) {
+				if (!writer.StartArray())
+					return false;
+				for (const typename Container::value_type& value : values) {
+					if (!WriteValue<TypeHelper<typename Container::value_type>>::write(writer, value, allocator))
+						return false;
+				}
+				return writer.EndArray();
+			}
+		};
+
+		template<class Container, template<class...> class TypeHelper>
+		struct WriteValue<ContainerTypeHelper<Container, TypeHelper>> : public WriteArray<Container, TypeHelper> {};
+
+		template<class StdArray, template<class...> class TypeHelper>
+		struct WriteValue<StdArrayTypeHelper<StdArray, TypeHelper>> : public WriteArray<StdArray, TypeHelper> {};
+
+		template<class Wrapper, class Element, template<class...> class TypeHelper>
+		struct WriteElement {
+			template<class Writer>
+			static inline bool write(Writer& writer, const Wrapper& value, Value::AllocatorType& allocator) {
+				return WriteValue<TypeHelper<Element>>::write(writer, *value, allocator);
+			}
+		};
+
+		template<class SmartPtr, template<class...> class TypeHelper>
+		struct WriteValue<SmartPtrTypeHelper<SmartPtr, TypeHelper>> :
+			public WriteElement<SmartPtr, typename SmartPtr::element_type, TypeHelper> {};
+
+		template<class Optional, template<class...> class TypeHelper>
+		struct WriteValue<OptionalTypeHelper<Optional, TypeHelper>> :
+			public WriteElement<Optional, typename Optional::value_type, TypeHelper> {};
+
+		template<class SourceObject, size_t i = 0, class Writer>
+		inline typename std::enable_if<i == std::tuple_size<decltype(SourceObject::JSONStruct)>::value, bool>::type
+			writeFields(Writer& /*writer*/, const SourceObject& /*object*/, Value::AllocatorType& /*allocator*/) {
+			return true;
+		}
+
+		template<class SourceObject, size_t i = 0, class Writer>
+		inline typename std::enable_if<i < std::tuple_size<decltype(SourceObject::JSONStruct)>::value, bool>::type
+			writeFields(Writer& writer, const SourceObject& object, Value::AllocatorType& allocator) {
+			constexpr auto field = std::get<i>(SourceObject::JSONStruct);
+			using Helper = typename decltype(field)::Helper;
+			if (!(field.type & OPTIONAL_NULLABLE_FIELD) || !Helper::empty(object.*(field.member))) {
+				constexpr std::size_t nameLength = stringLength(field.name);
+				if (!writer.Key(field.name, static_cast<SizeType>(nameLength)) ||
+					!WriteValue<Helper>::write(writer, object.*(field.member), allocator))
+					return false;
+			}
+			return writeFields<SourceObject, i + 1>(writer, object, allocator);
+		}
+
+		//allocator is for the values made by fromType
+		template<class Writer, class Object>
+		inline bool writeJSON(Writer& writer, const Object& object, Value::AllocatorType& allocator) {
+			return writer.StartObject() && writeFields(writer, object, allocator) && writer.EndObject();
+		}
+
+		//what stringify writes with, each thread keeps one between calls so that, once
+		//warmed up, only the returned string is allocated
+		struct WriteBuffers {
+			static constexpr std::size_t allocatorCapacity = 4 * 1024;
+			static constexpr std::size_t maxBufferCapacity = 1024 * 1024; //bigger buffers are freed after use
+
+			alignas(std::max_align_t) char allocatorBuffer[allocatorCapacity];
+			Value::AllocatorType allocator{ allocatorBuffer, allocatorCapacity };
 			rapidjson::StringBuffer buffer;
-			rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-			value.Accept(writer);
-			return std::string(buffer.GetString(), buffer.GetSize());
+			bool isInUse = false;
+
+			//gives the thread's buffers, or new ones when the thread's are already being used
+			template<class Callback>
+			static inline std::string use(Callback callback) {
+				thread_local WriteBuffers threadBuffers;
+				if (threadBuffers.isInUse) {
+					WriteBuffers buffers;
+					return buffers.write(callback);
+				}
+				return threadBuffers.write(callback);
+			}
+
+		private:
+			template<class Callback>
+			std::string write(Callback& callback) {
+				struct Release {
+					WriteBuffers& buffers;
+					~Release() {
+						const bool isTooBig = maxBufferCapacity < buffers.buffer.GetSize();
+						buffers.buffer.Clear();
+						if (isTooBig)
+							buffers.buffer.ShrinkToFit();
+						buffers.allocator.Clear();
+						buffers.isInUse = false;
+					}
+				} release{ *this };
+				isInUse = true;
+				rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+				callback(writer, allocator);
+				return std::string(buffer.GetString(), buffer.GetSize());
+			}
+		};
+
+		inline std::string stringify(const Value& value) {
+			return WriteBuffers::use([&value](rapidjson::Writer<rapidjson::StringBuffer>& writer, Value::AllocatorType&) {
+				value.Accept(writer);
+			});
 		}
 
 		template<class Object>
 		inline std::string stringifyObj(const Object& object) {
-			rapidjson::MemoryPoolAllocator<> allocator;
-			return stringify(toJSON(object, allocator));
+			return WriteBuffers::use([&object](rapidjson::Writer<rapidjson::StringBuffer>& writer, Value::AllocatorType& allocator) {
+				writeJSON(writer, object, allocator);
+			});
 		}
 
 		template<class Object, size_t i = 0>
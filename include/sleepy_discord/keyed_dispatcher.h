@@ -0,0 +1,144 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SleepyDiscord {
+	//Runs tasks with the same key one at a time in the order they were posted, while
+	//tasks with different keys can run at the same time on the client's postTask
+	//Keys are spread over a fixed number of queues, so different keys may share a queue
+	//Barriers run on their own, after every task posted before them and before any posted after
+	template<class Client>
+	class KeyedDispatcher {
+	public:
+		using Task = std::function<void()>;
+
+		KeyedDispatcher(Client& _client, const std::size_t queueCount = 64) :
+			client(_client), queues(queueCount < 1 ? 1 : queueCount) {}
+		KeyedDispatcher(const KeyedDispatcher&) = delete;
+		KeyedDispatcher& operator=(const KeyedDispatcher&) = delete;
+
+		void post(const uint64_t key, Task task) {
+			Queue& queue = queues[key % queues.size()];
+			if (push(queue, { std::move(task), nullptr }))
+				postDrain(queue);
+		}
+
+		//for tasks that change state that every other task uses, like the session
+		void postBarrier(Task task) {
+			//every queue stops at the barrier, and the last one to get there runs the task
+			const std::shared_ptr<Barrier> barrier = std::make_shared<Barrier>();
+			barrier->task = std::move(task);
+			barrier->remaining = queues.size();
+			for (Queue& queue : queues)
+				if (push(queue, { nullptr, barrier }))
+					postDrain(queue);
+		}
+
+		static uint64_t getKey(const char* data, const std::size_t length) {
+			uint64_t hash = 14695981039346656037ull;
+			for (std::size_t i = 0; i < length; ++i)
+				hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+			return hash;
+		}
+
+		//number of tasks per turn, after that the queue lets other work use the thread
+		static constexpr int maxTasksPerTurn = 32;
+
+	private:
+		struct Barrier {
+			Task task;
+			std::atomic<std::size_t> remaining; //queues that didn't get to the barrier yet
+		};
+		struct Entry {
+			Task task;
+			std::shared_ptr<Barrier> barrier; //when not null, the queue waits here for the others
+		};
+		struct Queue {
+			std::mutex mutex;
+			std::deque<Entry> tasks;
+			bool isRunning = false; //also true while waiting at a barrier
+		};
+
+		//returns true when the queue needs to be started
+		bool push(Queue& queue, Entry entry) {
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back(std::move(entry));
+			//a queue that's running will get to the task on its own
+			if (queue.isRunning)
+				return false;
+			queue.isRunning = true;
+			return true;
+		}
+
+		//keeps the queue going when a task throws
+		struct Turn {
+			KeyedDispatcher& dispatcher;
+			Queue& queue;
+			bool isFinished = false;
+			~Turn() {
+				if (!isFinished)
+					dispatcher.postDrain(queue);
+			}
+		};
+
+		void postDrain(Queue& queue) {
+			client.postTask([this, &queue]() {
+				drain(queue);
+			});
+		}
+
+		void drain(Queue& queue) {
+			Turn turn{ *this, queue };
+			for (int count = 0; count < maxTasksPerTurn; ++count) {
+				Entry entry;
+				{
+					std::lock_guard<std::mutex> lock(queue.mutex);
+					if (queue.tasks.empty()) {
+						queue.isRunning = false;
+						turn.isFinished = true;
+						return;
+					}
+					entry = std::move(queue.tasks.front());
+					queue.tasks.pop_front();
+				}
+				if (entry.barrier) {
+					//the queue stays running, so that it's not started again until the barrier is done
+					turn.isFinished = true;
+					if (--entry.barrier->remaining == 0)
+						runBarrier(*entry.barrier);
+					return;
+				}
+				entry.task();
+			}
+		}
+
+		//every queue is waiting at the barrier, so the task has the dispatcher to itself
+		void runBarrier(Barrier& barrier) {
+			//start the queues again, even when the task throws
+			struct Resume {
+				KeyedDispatcher& dispatcher;
+				~Resume() {
+					for (Queue& queue : dispatcher.queues) {
+						{
+							std::lock_guard<std::mutex> lock(queue.mutex);
+							if (queue.tasks.empty()) {
+								queue.isRunning = false;
+								continue;
+							}
+						}
+						dispatcher.postDrain(queue);
+					}
+				}
+			} resume{ *this };
+			barrier.task();
+		}
+
+		Client& client;
+		std::vector<Queue> queues;
+	};
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <memory>
+#include <bitset>
+#include <type_traits>
+#include "json_wrapper.h"
+
+namespace SleepyDiscord {
+	//An object that reads its fields from json the first time that they're used, so that
+	//fields that are never used don't cost anything. The json is kept alive by owner, which,
+	//for events, is the gateway frame the json is from. Fields are read like fromJSON reads
+	//them, and ones that are missing are left as their defaults.
+	//Note: reading fields changes the object, so like std::string, a lazy object can't be
+	//used from more than one thread at once. Lazy objects from events can be kept after
+	//their client is gone, they then keep the frame until they're destroyed.
+	template<class Object>
+	class LazyObject {
+	public:
+		static constexpr std::size_t fieldCount =
+			std::tuple_size<typename std::decay<decltype(Object::JSONStruct)>::type>::value;
+
+		LazyObject(std::shared_ptr<const void> _owner, json::Value& _json) :
+			owner(std::move(_owner)), json(&_json) {}
+		//an object that's already read, like one that was needed by a cache
+		explicit LazyObject(Object _object) : object(std::move(_object)) {
+			isRead.set();
+		}
+
+		//ex: message.get(&Message::content)
+		template<class Type, class Class>
+		const Type& get(Type Class::*member) const {
+			static_assert(std::is_base_of<Class, Object>::value, "member needs to be from the object");
+			read<0>(member);
+			return object.*member;
+		}
+
+		//reads all of the fields that weren't read yet
+		const Object& get() const {
+			if (!isRead.all()) {
+				object = Object(*json);
+				isRead.set();
+			}
+			return object;
+		}
+
+		//a copy of the whole object, without keeping it in here when it's not already read
+		Object toObject() const {
+			return isRead.all() ? object : Object(*json);
+		}
+
+		//null when the object didn't come from json
+		inline const json::Value* getJSON() const { return json; }
+
+	private:
+		template<class Member, class OtherMember>
+		static constexpr bool isSameMember(Member, OtherMember) { return false; }
+		template<class Member>
+		static constexpr bool isSameMember(Member member, Member otherMember) { return member == otherMember; }
+
+		//members that aren't in JSONStruct aren't from json, so they're left as they are
+		template<std::size_t i, class Member>
+		inline typename std::enable_if<i == fieldCount>::type read(Member) const {}
+
+		template<std::size_t i, class Member>
+		inline typename std::enable_if<i < fieldCount>::type read(Member member) const {
+			constexpr auto field = std::get<i>(Object::JSONStruct);
+			if (!isSameMember(field.member, member))
+				return read<i + 1>(member);
+			if (isRead[i])
+				return;
+			isRead.set(i);
+			if (!json->IsObject())
+				return;
+			using Helper = typename decltype(field)::Helper;
+			auto found = json->FindMember(field.name);
+			if (found != json->MemberEnd())
+				json::castValue<Helper>(object.*(field.member), found->value);
+		}
+
+		std::shared_ptr<const void> owner;
+		json::Value* json = nullptr;
+		mutable Object object;
+		mutable std::bitset<fieldCount> isRead;
+	};
+}
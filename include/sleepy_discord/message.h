@@ -10,6 +10,7 @@
 #include "snowflake.h"
 #include "channel.h"
 #include "nonstd/optional.hpp"
+#include "lazy_object.h"
 
 // <--- means to add later
 
@@ -538,6 +539,9 @@ namespace SleepyDiscord {
 		JSONStructEnd
 	};
 
+	//a message with fields that are only read when they're used
+	using LazyMessage = LazyObject<Message>;
+
 	inline MessageReference::MessageReference(const Message& message) :
 		messageID(message.ID),
 		channelID(message.channelID),
@@ -0,0 +1,79 @@
+#pragma once
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "message.h"
+#include "nonstd/optional.hpp"
+
+namespace SleepyDiscord {
+	//Keeps the most recent messages of each channel, so that edits and deletes can be
+	//shown with the message they changed without asking Discord for it
+	//Each channel has a ring buffer of messagesPerChannel messages, and once there are more
+	//than maxMessages in total, the oldest messages of the least active channels are dropped
+	//Note: thread safe, so copies are returned instead of references
+	class MessageCache {
+	public:
+		using Key = SnowflakeRaw::Type;
+
+		struct Settings {
+			std::size_t messagesPerChannel = 100;
+			std::size_t maxMessages = 10000;
+		};
+
+		MessageCache() : MessageCache(Settings()) {}
+		MessageCache(Settings _settings);
+		MessageCache(const MessageCache&) = delete;
+		MessageCache& operator=(const MessageCache&) = delete;
+
+		//replaces the message if it's already in the cache
+		void add(const Message& message);
+		//applies the changes to the cached message, and gives the message before and after them
+		//returns false if the message isn't in the cache
+		bool update(MessageRevisions& revisions, Message* before = nullptr, Message* after = nullptr);
+		tl::optional<Message> erase(const Snowflake<Channel>& channelID, const Snowflake<Message>& messageID);
+		void eraseChannel(const Snowflake<Channel>& channelID);
+		void eraseServer(const Snowflake<Server>& serverID);
+		void clear();
+
+		tl::optional<Message> find(const Snowflake<Channel>& channelID, const Snowflake<Message>& messageID) const;
+		//newest first
+		std::vector<Message> getRecent(const Snowflake<Channel>& channelID, std::size_t limit = 0) const;
+		std::size_t size() const;
+		inline const Settings& getSettings() const { return settings; }
+
+	private:
+		struct Slot {
+			Message message;
+			bool isUsed = false;
+		};
+
+		//slots fill up to messagesPerChannel, then next is the oldest slot and gets overwritten
+		struct Ring {
+			std::vector<Slot> slots;
+			std::size_t next = 0;
+			std::size_t used = 0;
+			Snowflake<Server> serverID;
+			std::list<Key>::iterator activity;
+
+			//Note: slots can't be empty
+			inline std::size_t oldest() const { return next % slots.size(); }
+			const Slot* find(const Key& messageID) const;
+			inline Slot* find(const Key& messageID) {
+				return const_cast<Slot*>(static_cast<const Ring&>(*this).find(messageID));
+			}
+		};
+
+		//these expect mutex to be locked
+		Ring* findRing(const Key& channelID);
+		void removeSlot(Ring& ring, Slot& slot);
+		void removeRing(std::unordered_map<Key, Ring>::iterator ring);
+		void evictOldest();
+
+		Settings settings;
+		mutable std::mutex mutex;
+		std::unordered_map<Key, Ring> channels;
+		std::list<Key> activity; //most recently active channel first
+		std::size_t total = 0;
+	};
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <shared_mutex>
+#include <unordered_map>
+#include "permissions.h"
+#include "server.h"
+#include "channel.h"
+
+namespace SleepyDiscord {
+	//Remembers the base permissions of members and the overwrites of channels, so that
+	//getPermissions doesn't look through the roles and overwrites every time
+	//Entries are made from the objects passed in the first time they're needed, and the
+	//client forgets them when gateway events change roles, members or channels
+	//Note: thread safe
+	class PermissionCache {
+	public:
+		using Key = SnowflakeRaw::Type;
+
+		PermissionCache() = default;
+		PermissionCache(const PermissionCache&) = delete;
+		PermissionCache& operator=(const PermissionCache&) = delete;
+
+		//same results as the functions in permissions.h
+		Permission getBasePermissions(const Server& server, const ServerMember& member);
+		Permission getPermissions(const Server& server, const ServerMember& member, const Channel& channel);
+
+		//for when the roles or owner of a server change
+		void invalidateServer(const Snowflake<Server>& serverID);
+		void invalidateMember(const Snowflake<Server>& serverID, const Snowflake<User>& userID);
+		void invalidateChannel(const Snowflake<Channel>& channelID);
+		//forgets the server and its channels
+		void eraseServer(const Snowflake<Server>& serverID);
+		void clear();
+
+	private:
+		using SharedMutex = std::shared_timed_mutex;
+		using ReadLock = std::shared_lock<SharedMutex>;
+		using WriteLock = std::unique_lock<SharedMutex>;
+
+		struct Masks {
+			Permission allow = NONE;
+			Permission deny = NONE;
+		};
+
+		//the overwrites of a channel by the id of the role or member they're for
+		struct ChannelMasks {
+			ChannelMasks() = default;
+			ChannelMasks(const Server& server, const Channel& channel);
+			Key serverID = 0;
+			Masks everyone;
+			std::unordered_map<Key, Masks> overwrites;
+
+			inline const Masks* find(const Key& ID) const {
+				auto found = overwrites.find(ID);
+				return found != overwrites.end() ? &found->second : nullptr;
+			}
+			//the permissions of member in the channel
+			Permission apply(Permission permissions, const ServerMember& member) const;
+		};
+
+		//changes every time a server's base permissions are invalidated, so that permissions
+		//worked out before an invalidation aren't stored after it
+		//Note: needs mutex to be locked
+		inline uint64_t getGeneration(const Key& serverID) const {
+			auto found = generations.find(serverID);
+			return clearCount + (found != generations.end() ? found->second : 0);
+		}
+
+		mutable SharedMutex mutex;
+		std::unordered_map<Key, std::unordered_map<Key, Permission>> basePermissions; //server to member to permissions
+		std::unordered_map<Key, ChannelMasks> channels;
+		std::unordered_map<Key, uint64_t> generations;
+		uint64_t clearCount = 0;
+	};
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <algorithm>
 #include <cstdlib>
 #include "discord_object_interface.h"
@@ -9,6 +10,7 @@
 //source: discord api docs | /topics/Permissions.md | Nov 16
 
 namespace SleepyDiscord {
+	struct User;
 	struct ServerMember;
 	struct Server;
 	struct Overwrite;
@@ -83,6 +85,42 @@ namespace SleepyDiscord {
 	Permission overwritePermissions(const Permission basePermissions, const Server& server, const ServerMember& member, const Channel& channel);
 	Permission getPermissions(const Server& server, const ServerMember& member, const Channel& channel);
 
+	//The permissions of every member of a server in one channel, worked out in one pass
+	//Roles and overwrites are flattened into arrays first, so each member is only a few
+	//ORs and ANDs over them instead of looking through the roles and overwrites
+	//Note: members are in the order of server.members when the object was made, bitmaps
+	//have the bit i % 64 of the word i / 64 for getMemberIDs()[i]
+	class ChannelPermissions {
+	public:
+		ChannelPermissions(const Server& server, const Channel& channel);
+
+		inline std::size_t size() const { return memberIDs.size(); }
+		inline const std::vector<Snowflake<User>>& getMemberIDs() const { return memberIDs; }
+		std::vector<Permission> getPermissions() const;
+		//which members have all of permission
+		std::vector<uint64_t> getBitmap(const Permission permission) const;
+		std::vector<Snowflake<User>> getMembersWith(const Permission permission) const;
+
+	private:
+		template<class Output>
+		void evaluate(Output output) const;
+
+		std::vector<Snowflake<User>> memberIDs;
+		//by role index
+		std::vector<PermissionRaw> rolePermissions;
+		std::vector<PermissionRaw> roleAllow;
+		std::vector<PermissionRaw> roleDeny;
+		//by member index, the roles of member i are memberRoles[roleOffsets[i]] to memberRoles[roleOffsets[i + 1]]
+		std::vector<uint32_t> roleOffsets;
+		std::vector<uint32_t> memberRoles;
+		std::vector<PermissionRaw> memberAllow;
+		std::vector<PermissionRaw> memberDeny;
+		std::vector<PermissionRaw> isOwner; //all bits set for the owner
+		PermissionRaw everyonePermissions = 0;
+		PermissionRaw everyoneAllow = 0;
+		PermissionRaw everyoneDeny = 0;
+	};
+
 	template<class Type>
 	struct UInt64StrTypeHelper {
 		static inline Permission toType(const json::Value& value) {
@@ -1,105 +1,348 @@
 #pragma once
+#include <cstdint>
+#include <memory>
+#include <chrono>
+#include <condition_variable>
 #include "client.h"
 
 namespace SleepyDiscord {
 
+	//A path with {parameters} in it, like "channels/{channel.id}/messages"
+	//When made from a string literal, the id and the major parameter are worked out at
+	//compile time, so use constexpr RouteTemplates for routes that are used a lot
+	struct RouteTemplate {
+		template<std::size_t size>
+		constexpr RouteTemplate(const char (&source)[size]) :
+			path(source), length(size - 1), id(hashPath(source)), majorParameter(findMajorParameter(source)) {}
+		//path isn't copied, so it needs to outlive the template
+		RouteTemplate(const char* source, std::size_t _length) :
+			path(source), length(_length), id(hashPath(source)), majorParameter(findMajorParameter(source)) {}
+
+		const char* path;
+		std::size_t length;
+		uint32_t id;
+		int majorParameter; //index of the major parameter, -1 when there isn't one
+
+		static constexpr uint32_t hashPath(const char* source, uint32_t hash = 2166136261u) {
+			return !*source ? hash : hashPath(source + 1, (hash ^ static_cast<unsigned char>(*source)) * 16777619u);
+		}
+
+	private:
+		static constexpr bool startsWith(const char* source, const char* prefix) {
+			return !*prefix ? true : *source == *prefix && startsWith(source + 1, prefix + 1);
+		}
+		static constexpr bool isMajorParameter(const char* name) {
+			return startsWith(name, "channel.id}") || startsWith(name, "guild.id}") || startsWith(name, "webhook.id}");
+		}
+		static constexpr const char* skipParameter(const char* source) {
+			return !*source || *source == '}' ? source : skipParameter(source + 1);
+		}
+		static constexpr int findMajorParameter(const char* source, int index = 0) {
+			return
+				!*source ? -1 :
+				*source != '{' ? findMajorParameter(source + 1, index) :
+				isMajorParameter(source + 1) ? index :
+				findMajorParameter(skipParameter(source), index + 1);
+		}
+	};
+
 	class Route {
 	public:
-		using Bucket = std::string;
-		Route(const std::string route, const std::initializer_list<std::string>& _values = {});
+		//route id and method, with the major parameter's snowflake
+		struct Bucket {
+			uint64_t route;
+			uint64_t majorID;
+			inline bool operator==(const Bucket& right) const {
+				return route == right.route && majorID == right.majorID;
+			}
+		};
+		struct BucketHash {
+			inline std::size_t operator()(const Bucket& bucket) const {
+				return static_cast<std::size_t>(bucket.route * 0x9E3779B97F4A7C15ull ^ bucket.majorID);
+			}
+		};
+
+		Route(const RouteTemplate& route, const std::initializer_list<std::string>& values = {});
+		Route(const std::string route, const std::initializer_list<std::string>& values = {});
 		Route(const char* route);
-		inline const std::string& url() {
+		inline const std::string& url() const {
 			return _url;
 		}
-		const Bucket bucket(RequestMethod method);
-		inline operator const std::string&() {
+		inline const Bucket bucket(RequestMethod method) const {
+			return { static_cast<uint64_t>(routeTemplate.id) << 3 | static_cast<uint64_t>(method), majorID };
+		}
+		inline operator const std::string&() const {
 			return url();
 		}
-		inline const std::string& getPath() {
-			return path;
+		inline std::string getPath() const {
+			return std::string(routeTemplate.path, routeTemplate.length);
 		}
 
 	private:
-		const std::string path;
+		void build(const std::initializer_list<std::string>& values);
+
+		//used when the path isn't from a RouteTemplate, so that it stays alive
+		std::shared_ptr<const std::string> ownedPath;
+		RouteTemplate routeTemplate;
 		std::string _url;
-		const std::initializer_list<std::string>& values;
-
-		//for the snowflake part, discord class should do
-		std::unordered_map<std::string, Snowflake<User>::RawType>
-			majorParameters = {
-			{ "channel.id", {} },
-			{ "guild.id"  , {} },
-			{ "webhook.id", {} }
-		};
+		uint64_t majorID = 0;
 	};
 
 	//note: all rate limiter data needs to be handled in a sync manner
 	template<class Client>
 	struct RateLimiter {
+		using Request = typename Client::Request;
+
+		RateLimiter(Client& _client) : client(_client) {}
+
 		std::atomic<bool> isGlobalRateLimited = { false };
 		std::atomic<time_t> nextRetry = { 0 };
-		void limitBucket(const Route::Bucket& bucket, const std::string& xBucket, time_t timestamp)  {
+		int globalLimit = 50; //number of requests allowed per second across all buckets
+		//in milliseconds, how long the first request to a bucket has to come back before
+		//others are let through without knowing the bucket's limit
+		time_t probeTimeout = 5000;
+
+		//Takes a request's worth of capacity from the bucket. Returns 0 when the request
+		//can be made right now, otherwise the timestamp of when there might be capacity
+		time_t acquire(const Route::Bucket& bucket, const time_t currentTime) {
 			std::lock_guard<std::mutex> lock(mutex);
-			buckets[bucket] = xBucket;
-			limits[xBucket].nextTry = timestamp;
+			return tryAcquire(bucket, currentTime);
 		}
-		
-		const time_t getLiftTime(Route::Bucket& bucket, const time_t& currentTime) {
-			if (isGlobalRateLimited && currentTime < nextRetry)
-					return nextRetry;
-			isGlobalRateLimited = false;
-			std::lock_guard<std::mutex> lock(mutex);
-			auto actualBucket = buckets.find(bucket);
-			if (actualBucket != buckets.end()) {
-				auto rateLimit = limits.find(actualBucket->second);
-				if (rateLimit != limits.end()) {
-					if (currentTime < rateLimit->second.nextTry)
-						return rateLimit->second.nextTry;
-					limits.erase(rateLimit);
-				}
-				buckets.erase(actualBucket);
+
+		//Like acquire, but blocks until there's capacity, for requests that can't be queued
+		void wait(const Route::Bucket& bucket) {
+			std::unique_lock<std::mutex> lock(mutex);
+			while (true) {
+				const time_t currentTime = client.getEpochTimeMillisecond();
+				const time_t liftTime = tryAcquire(bucket, currentTime);
+				if (liftTime == 0)
+					return;
+				//woken up early when a response changes the limits
+				changed.wait_for(lock, std::chrono::milliseconds(liftTime - currentTime));
 			}
-			return 0;
 		}
-		//isLimited also returns the next Retry timestamp
 
+		//Request is made once there's capacity for it, after the requests queued before it
+		void enqueue(const Route::Bucket& bucket, Request request, const time_t currentTime) {
+			std::lock_guard<std::mutex> lock(mutex);
+			//buckets we don't know about yet get a queue of their own
+			const std::string& key = buckets.emplace(bucket, getUnknownKey(bucket)).first->second;
+			RateLimit& rateLimit = limits[key];
+			rateLimit.awaitingRequest.push_back(std::move(request));
+			scheduleDrain(key, rateLimit, getDrainTime(rateLimit, currentTime), currentTime);
+		}
+
+		//Updates the bucket from the X-RateLimit headers of a response
+		//returns true when there's no requests left in the bucket
+		bool update(const Route::Bucket& bucket, const std::string& xBucket,
+			const int limit, const int remaining, const time_t resetAfter, const time_t currentTime
+		) {
+			const std::string limitKey = getLimitKey(bucket, xBucket);
+			std::lock_guard<std::mutex> lock(mutex);
+			RateLimit& rateLimit = setLimitKey(bucket, limitKey);
+			rateLimit.probeEnd = 0;
+			const time_t resetAt = currentTime + resetAfter;
+			//requests that are still being made already took from remaining,
+			//so only trust Discord's remaining when it's lower or it's a new window
+			if (!rateLimit.isKnown() || rateLimit.resetAt <= currentTime || remaining < rateLimit.remaining)
+				rateLimit.remaining = remaining;
+			rateLimit.limit = 0 < limit ? limit : 1;
+			rateLimit.resetAt = resetAt;
+			if (!rateLimit.awaitingRequest.empty())
+				scheduleDrain(limitKey, rateLimit, getDrainTime(rateLimit, currentTime), currentTime);
+			changed.notify_all();
+			return rateLimit.remaining <= 0;
+		}
+
+		//For responses without X-RateLimit headers, so that the bucket doesn't wait on them
+		void finish(const Route::Bucket& bucket, const time_t currentTime) {
+			std::lock_guard<std::mutex> lock(mutex);
+			auto key = buckets.find(bucket);
+			if (key == buckets.end())
+				return;
+			RateLimit& rateLimit = limits[key->second];
+			if (rateLimit.probeEnd == 0)
+				return;
+			rateLimit.probeEnd = 0;
+			if (!rateLimit.awaitingRequest.empty())
+				scheduleDrain(key->second, rateLimit, getDrainTime(rateLimit, currentTime), currentTime);
+			changed.notify_all();
+		}
+
+		//Used after a 429 to stop requests to the bucket until the timestamp
+		//xBucket can be empty when Discord didn't give one
+		void limitBucket(const Route::Bucket& bucket, const std::string& xBucket, time_t timestamp) {
+			std::lock_guard<std::mutex> lock(mutex);
+			const std::string key = xBucket.empty() ?
+				buckets.emplace(bucket, getUnknownKey(bucket)).first->second :
+				getLimitKey(bucket, xBucket);
+			RateLimit& rateLimit = setLimitKey(bucket, key);
+			rateLimit.probeEnd = 0;
+			if (!rateLimit.isKnown())
+				rateLimit.limit = 1;
+			rateLimit.remaining = 0;
+			rateLimit.resetAt = timestamp;
+			const time_t currentTime = client.getEpochTimeMillisecond();
+			if (!rateLimit.awaitingRequest.empty())
+				scheduleDrain(key, rateLimit, getDrainTime(rateLimit, currentTime), currentTime);
+		}
+
+		void limitGlobal(time_t timestamp) {
+			std::lock_guard<std::mutex> lock(mutex);
+			nextRetry = timestamp;
+			isGlobalRateLimited = true;
+			changed.notify_all();
+		}
+
+	private:
 		struct RateLimit {
-		public:
-			void doWaitingRequest()  {
-				if (awaitingRequest.empty())
-					return;
-				RateLimiter& rateLimiter = awaitingRequest.front().client.rateLimiter;
+			int limit = 0; //0 when Discord hasn't told us the limit yet
+			int remaining = 0;
+			time_t resetAt = 0;
+			//until the limit is known, one request at a time is let through to find it, until this time
+			time_t probeEnd = 0;
+			std::list<Request> awaitingRequest;
+			Timer expireTimer;
+			time_t expireTime = 0;
 
-				std::lock_guard<std::mutex> lock(rateLimiter.mutex);
-				awaitingRequest.remove_if([](typename Client::Request& request){
-					request.client.postTask(request);
-					return true;
-				});
+			inline bool isKnown() const { return 0 < limit; }
+			inline void refill(const time_t currentTime) {
+				if (resetAt <= currentTime)
+					remaining = limit;
+			}
+			//0 when there's capacity for a new request
+			inline time_t getLiftTime(const time_t currentTime) {
+				refill(currentTime);
+				//requests that are waiting go first
+				if (!awaitingRequest.empty())
+					return currentTime < resetAt ? resetAt : currentTime;
+				if (isKnown() && remaining <= 0)
+					return resetAt;
+				if (isProbing(currentTime))
+					return probeEnd;
+				return 0;
+			}
+			inline bool isProbing(const time_t currentTime) const {
+				return !isKnown() && currentTime < probeEnd;
 			}
-		private:
-			friend RateLimiter;
-			std::list<typename Client::Request> awaitingRequest;
-			time_t nextTry = 0; // to do for v8, make this seconds
-			static constexpr int defaultLimit = 1;
-			int limit = defaultLimit;
-			int remaining = defaultLimit;
-			Timer expireTimer;
 		};
 
-		class HandleAwaitAfterRequest {
-		public:
-			HandleAwaitAfterRequest(RateLimiter::RateLimit& limit)
-				: rateLimit(limit) {}
-			~HandleAwaitAfterRequest() {
-				rateLimit.doWaitingRequest();
+		//a rate limit is shared by all routes with the same X-RateLimit-Bucket and major parameter
+		static std::string getLimitKey(const Route::Bucket& bucket, const std::string& xBucket) {
+			return xBucket + ':' + std::to_string(bucket.majorID);
+		}
+		static std::string getUnknownKey(const Route::Bucket& bucket) {
+			return "route:" + std::to_string(bucket.route) + ':' + std::to_string(bucket.majorID);
+		}
+
+		//the functions below need mutex to be locked
+
+		time_t tryAcquire(const Route::Bucket& bucket, const time_t currentTime) {
+			time_t liftTime = getGlobalLiftTime(currentTime);
+			//buckets we don't know about yet get a limit of their own
+			RateLimit& rateLimit = limits[buckets.emplace(bucket, getUnknownKey(bucket)).first->second];
+			if (liftTime == 0)
+				liftTime = rateLimit.getLiftTime(currentTime);
+			if (liftTime != 0)
+				return liftTime;
+			take(rateLimit, currentTime);
+			return 0;
+		}
+
+		//points the bucket to the limit with the key, and moves over the requests that were
+		//waiting with the limit used before Discord told us the bucket
+		RateLimit& setLimitKey(const Route::Bucket& bucket, const std::string& key) {
+			RateLimit& rateLimit = limits[key];
+			std::string& oldKey = buckets[bucket];
+			if (oldKey != key && oldKey == getUnknownKey(bucket)) {
+				auto oldLimit = limits.find(oldKey);
+				if (oldLimit != limits.end() && !oldLimit->second.awaitingRequest.empty()) {
+					if (oldLimit->second.expireTimer.isValid())
+						oldLimit->second.expireTimer.stop();
+					oldLimit->second.expireTimer = Timer();
+					rateLimit.awaitingRequest.splice(rateLimit.awaitingRequest.begin(), oldLimit->second.awaitingRequest);
+				}
 			}
-		private:
-			RateLimiter::RateLimit& rateLimit;
-		};
+			oldKey = key;
+			return rateLimit;
+		}
 
-	private:
-		std::unordered_map<Route::Bucket, std::string> buckets;
+		time_t getGlobalLiftTime(const time_t currentTime) {
+			if (isGlobalRateLimited) {
+				if (currentTime < nextRetry)
+					return nextRetry;
+				isGlobalRateLimited = false;
+			}
+			if (globalWindowEnd <= currentTime) {
+				globalWindowEnd = currentTime + 1000;
+				globalRemaining = globalLimit;
+			}
+			return 0 < globalRemaining ? 0 : globalWindowEnd;
+		}
+
+		time_t getDrainTime(RateLimit& rateLimit, const time_t currentTime) {
+			const time_t globalLiftTime = getGlobalLiftTime(currentTime);
+			rateLimit.refill(currentTime);
+			const time_t liftTime =
+				rateLimit.isKnown() && rateLimit.remaining <= 0 ? rateLimit.resetAt :
+				rateLimit.isProbing(currentTime) ? rateLimit.probeEnd :
+				currentTime;
+			return liftTime < globalLiftTime ? globalLiftTime : liftTime;
+		}
+
+		void take(RateLimit& rateLimit, const time_t currentTime) {
+			--globalRemaining;
+			if (rateLimit.isKnown())
+				--rateLimit.remaining;
+			else
+				rateLimit.probeEnd = currentTime + probeTimeout;
+		}
+
+		void scheduleDrain(const std::string& key, RateLimit& rateLimit, const time_t drainTime, const time_t currentTime) {
+			if (rateLimit.expireTimer.isValid()) {
+				if (rateLimit.expireTime <= drainTime)
+					return; //the drain that's already scheduled will reschedule if needed
+				rateLimit.expireTimer.stop();
+			}
+			rateLimit.expireTime = drainTime;
+			rateLimit.expireTimer = client.schedule([this, key]() {
+				drain(key);
+			}, currentTime < drainTime ? drainTime - currentTime : 0);
+		}
+
+		void drain(const std::string key) {
+			std::list<Request> ready;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				auto found = limits.find(key);
+				if (found == limits.end())
+					return;
+				RateLimit& rateLimit = found->second;
+				rateLimit.expireTimer = Timer();
+				const time_t currentTime = client.getEpochTimeMillisecond();
+				while (!rateLimit.awaitingRequest.empty()) {
+					const time_t drainTime = getDrainTime(rateLimit, currentTime);
+					if (currentTime < drainTime) {
+						scheduleDrain(key, rateLimit, drainTime, currentTime);
+						break;
+					}
+					take(rateLimit, currentTime);
+					ready.splice(ready.end(), rateLimit.awaitingRequest, rateLimit.awaitingRequest.begin());
+				}
+			}
+			//capacity was already taken for these, so they skip the rate limiter
+			for (Request& request : ready)
+				client.postTask([request]() {
+					request.perform();
+				});
+		}
+
+		Client& client;
+		std::unordered_map<Route::Bucket, std::string, Route::BucketHash> buckets;
 		std::unordered_map<std::string, RateLimit> limits;
+		time_t globalWindowEnd = 0;
+		int globalRemaining = 0;
 		std::mutex mutex;
+		std::condition_variable changed;
 	};
-}
\ No newline at end of file
+}
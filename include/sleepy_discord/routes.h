@@ -0,0 +1,83 @@
+#pragma once
+#include "rate_limiter.h"
+
+namespace SleepyDiscord {
+	//Routes to Discord's REST API, worked out at compile time
+	namespace Routes {
+		//channel
+		constexpr RouteTemplate channel                   = "channels/{channel.id}";
+		constexpr RouteTemplate channelMessages           = "channels/{channel.id}/messages";
+		constexpr RouteTemplate channelMessagesQuery      = "channels/{channel.id}/messages{key}{limit}";
+		constexpr RouteTemplate channelMessage            = "channels/{channel.id}/messages/{message.id}";
+		constexpr RouteTemplate channelMessagesBulkDelete = "channels/{channel.id}/messages/bulk-delete";
+		constexpr RouteTemplate messageReactions          = "channels/{channel.id}/messages/{message.id}/reactions";
+		constexpr RouteTemplate messageReaction           = "channels/{channel.id}/messages/{message.id}/reactions/{emoji}";
+		constexpr RouteTemplate messageOwnReaction        = "channels/{channel.id}/messages/{message.id}/reactions/{emoji}/@me";
+		constexpr RouteTemplate messageUserReaction       = "channels/{channel.id}/messages/{message.id}/reactions/{emoji}/{user.id}";
+		constexpr RouteTemplate channelPermission         = "channels/{channel.id}/permissions/{overwrite.id}";
+		constexpr RouteTemplate channelInvites            = "channels/{channel.id}/invites";
+		constexpr RouteTemplate channelTyping             = "channels/{channel.id}/typing";
+		constexpr RouteTemplate channelPins               = "channels/{channel.id}/pins";
+		constexpr RouteTemplate channelPin                = "channels/{channel.id}/pins/{message.id}";
+		constexpr RouteTemplate channelRecipient          = "channels/{channel.id}/recipients/{user.id}";
+		constexpr RouteTemplate channelWebhooks           = "channels/{channel.id}/webhooks";
+
+		//server
+		constexpr RouteTemplate servers               = "guilds";
+		constexpr RouteTemplate server                = "guilds/{guild.id}";
+		constexpr RouteTemplate serverChannels        = "guilds/{guild.id}/channels";
+		constexpr RouteTemplate serverMembersQuery    = "guilds/{guild.id}/members{limit}{after}";
+		constexpr RouteTemplate serverMember          = "guilds/{guild.id}/members/{user.id}";
+		constexpr RouteTemplate serverOwnNickname     = "guilds/{guild.id}/members/@me/nick";
+		constexpr RouteTemplate serverMemberRole      = "guilds/{guild.id}/members/{user.id}/roles/{role.id}";
+		constexpr RouteTemplate serverBans            = "guilds/{guild.id}/bans";
+		constexpr RouteTemplate serverBan             = "guilds/{guild.id}/bans/{user.id}";
+		constexpr RouteTemplate serverRoles           = "guilds/{guild.id}/roles";
+		constexpr RouteTemplate serverRole            = "guilds/{guild.id}/roles/{role.id}";
+		constexpr RouteTemplate serverPrune           = "guilds/{guild.id}/prune";
+		constexpr RouteTemplate serverRegions         = "guilds/{guild.id}/regions";
+		constexpr RouteTemplate serverInvites         = "guilds/{guild.id}/invites";
+		constexpr RouteTemplate serverIntegrations    = "guilds/{guild.id}/integrations";
+		constexpr RouteTemplate serverIntegration     = "guilds/{guild.id}/integrations/{integration.id}";
+		constexpr RouteTemplate serverIntegrationSync = "guilds/{guild.id}/integrations/{integration.id}/sync";
+		constexpr RouteTemplate serverWidget          = "guilds/{guild.id}/widget";
+		constexpr RouteTemplate serverWebhooks        = "guilds/{guild.id}/webhooks";
+
+		//user
+		constexpr RouteTemplate currentUser            = "users/@me";
+		constexpr RouteTemplate user                   = "users/{user.id}";
+		constexpr RouteTemplate currentUserServers     = "users/@me/guilds";
+		constexpr RouteTemplate currentUserServer      = "users/@me/guilds/{guild.id}";
+		constexpr RouteTemplate currentUserChannels    = "users/@me/channels";
+		constexpr RouteTemplate currentUserConnections = "users/@me/connections";
+
+		//invite
+		constexpr RouteTemplate invite = "invites/{invite.code}";
+
+		//webhook
+		constexpr RouteTemplate webhookWithToken            = "webhooks/{webhook.id}/{webhook.token}";
+		constexpr RouteTemplate executeWebhook              = "webhooks/{webhook.id}/{webhook.token}{wait}";
+		constexpr RouteTemplate followupMessages            = "webhooks/{application.id}/{interaction.token}";
+		constexpr RouteTemplate originalInteractionResponse = "webhooks/{application.id}/{interaction.token}/messages/@original";
+		constexpr RouteTemplate followupMessage             = "webhooks/{application.id}/{interaction.token}/messages/{message.id}";
+		constexpr RouteTemplate webhook                     = "webhooks/{webhook.id}";
+
+		//interaction
+		constexpr RouteTemplate interactionCallback = "interactions/{interaction.id}/{interaction.token}/callback";
+
+		//app command
+		constexpr RouteTemplate globalAppCommands            = "applications/{application.id}/commands";
+		constexpr RouteTemplate globalAppCommand             = "applications/{application.id}/commands/{command.id}";
+		constexpr RouteTemplate serverAppCommands            = "applications/{application.id}/guilds/{guild.id}/commands";
+		constexpr RouteTemplate serverAppCommand             = "applications/{application.id}/guilds/{guild.id}/commands/{command.id}";
+		constexpr RouteTemplate serverAppCommandsPermissions = "applications/{application.id}/guilds/{guild.id}/commands/permissions";
+		constexpr RouteTemplate serverAppCommandPermissions  = "applications/{application.id}/guilds/{guild.id}/commands/{command.id}/permissions";
+
+		//stage instance
+		constexpr RouteTemplate stageInstances = "/stage-instances";
+		constexpr RouteTemplate stageInstance  = "/stage-instances/{channel.id}";
+
+		//gateway
+		constexpr RouteTemplate gatewayBot = "gateway/bot";
+	}
+}
@@ -1,12 +1,20 @@
 #pragma once
+#include <array>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include "discord_object_interface.h"
 #include "user.h"
 #include "channel.h"
 #include "stage_instance.h"
 #include "snowflake.h"
 #include "cache.h"
+#include "cache_policy.h"
 #include "voice.h"
+#include "permissions.h"
+#include "lazy_object.h"
 
 namespace SleepyDiscord {
 	enum Permission : uint64_t;
@@ -56,6 +64,15 @@ namespace SleepyDiscord {
 			);
 		JSONStructEnd
 	};
+
+	namespace json {
+		template<>
+		struct AfterFromJSON<ServerMember> {
+			static inline void apply(ServerMember& member) {
+				member.ID = member.user.ID;
+			}
+		};
+	}
     
 	struct Server : public IdentifiableDiscordObject<Server> {
 		~Server() = default;
@@ -78,7 +95,7 @@ namespace SleepyDiscord {
 		int defaultMessageNotifications;
 		int explicitContentFilter;
         
-		std::list<Role> roles;
+		Cache<Role> roles;
 		std::list<VoiceState> voiceStates;
 		//emojis
 		std::vector<std::string> features;
@@ -107,12 +124,13 @@ namespace SleepyDiscord {
 		//those are only filled in from the onServer event
 		bool large;
 		int memberCount = 0;
-		std::list<ServerMember> members;
-		std::list<Channel> channels;
+		//kept in caches, so that finding one of them by id takes constant time
+		Cache<ServerMember> members;
+		Cache<Channel> channels;
 
-		std::list<ServerMember>::iterator findMember(const Snowflake<User> userID);
-		std::list<Channel>::iterator findChannel(const Snowflake<Channel> channelID);
-		std::list<Role>::iterator findRole(const Snowflake<Role> roleID);
+		Cache<ServerMember>::iterator findMember(const Snowflake<User> userID);
+		Cache<Channel>::iterator findChannel(const Snowflake<Channel> channelID);
+		Cache<Role>::iterator findRole(const Snowflake<Role> roleID);
 
 		JSONStructStart
 			std::make_tuple(
@@ -162,6 +180,8 @@ namespace SleepyDiscord {
 		JSONStructEnd
 	};
 
+	using LazyServer = LazyObject<Server>;
+
 	struct UnavailableServer : public IdentifiableDiscordObject<Server> {
 		UnavailableServer() = default;
 		//UnavailableServer(const std::string * rawJson);
@@ -199,36 +219,227 @@ namespace SleepyDiscord {
 		using Value = bool; 
 	};
 
+	//Also keeps indexes of which servers have a channel, role or member, so that finding
+	//them is constant time
+	//Note: the indexes are kept up to date by insert, erase and the index functions, so
+	//objects added to or removed from a server some other way need to use them too
+	//
+	//The cache can be used from more than one thread with the access and read functions.
+	//Servers are spread over lock stripes, so a server being changed only blocks readers
+	//of servers in the same stripe. Iterators, and the find functions that give them,
+	//aren't protected by any lock.
+	//
+	//Members, channels and roles each have a cache policy, so that the cache can keep only
+	//some of them. By default everything is kept.
 	class ServerCache : public Cache<Server> {
 	public:
-		using Cache<Server>::Cache;
+		using ServerIDs = std::unordered_set<Key>;
+
+		struct Policies {
+			CachePolicy members;
+			CachePolicy channels;
+			CachePolicy roles;
+		};
+		struct Counters {
+			CacheCounters members;
+			CacheCounters channels;
+			CacheCounters roles;
+		};
+
 		ServerCache() : Cache() {} //for some odd reason the default constructor isn't inherited
-		ServerCache(Cache<Server> list) : Cache<Server>(list) {}
-
-		/*
-		//Linear time complexity if unordered map: to do figure out how to do this with constant time complexity
-		template<class Container, class Object>
-		iterator findOneWithObject(Container Server::*list, const Snowflake<Object>& objectID) {
-			return std::find_if(begin(), end(), [&objectID, list](Server& server) {
-				auto result = objectID.findObject(server.*list);
-				return result != std::end(server.*list);
-			});
+		ServerCache(Cache<Server> list) : Cache<Server>(std::move(list)) { rebuildIndexes(); }
+		template<class InputIterator>
+		ServerCache(InputIterator first, InputIterator last) : Cache<Server>(first, last) {
+			rebuildIndexes();
+		}
+
+		//replaces the server if it's already in the cache
+		std::pair<iterator, bool> insert(const Server& server);
+		iterator erase(const_iterator pos);
+		bool erase(const Snowflake<Server>& serverID);
+
+		//calls callback with the server while no other thread can use it, returns false if
+		//the server isn't in the cache
+		//Note: don't keep references to the server after the callback returns
+		template<class Callback>
+		bool accessServer(const Snowflake<Server>& serverID, Callback callback) {
+			ReadLock serversLock(locks.servers);
+			auto found = Parent::find(serverID.raw());
+			if (found == Parent::end())
+				return false;
+			WriteLock serverLock(getStripe(found->first));
+			callback(found->second);
+			return true;
 		}
-		*/
 
+		//like accessServer, but other threads can read the server at the same time
+		template<class Callback>
+		bool readServer(const Snowflake<Server>& serverID, Callback callback) const {
+			ReadLock serversLock(locks.servers);
+			auto found = Parent::find(serverID.raw());
+			if (found == Parent::end())
+				return false;
+			ReadLock serverLock(getStripe(found->first));
+			callback(static_cast<const Server&>(found->second));
+			return true;
+		}
+
+		//calls callback with each server, while no other thread can change it
+		template<class Callback>
+		void readServers(Callback callback) const {
+			ReadLock serversLock(locks.servers);
+			for (auto found = Parent::begin(); found != Parent::end(); ++found) {
+				ReadLock serverLock(getStripe(found->first));
+				callback(static_cast<const Server&>(found->second));
+			}
+		}
+
+		template<class Callback>
+		inline bool readServerWith(const Snowflake<Channel>& channelID, Callback callback) const {
+			return readServer(findIndexed(channelServers, channelID), callback);
+		}
+
+		template<class Callback>
+		inline bool readServerWith(const Snowflake<Role>& roleID, Callback callback) const {
+			return readServer(findIndexed(roleServers, roleID), callback);
+		}
+
+		inline const_iterator findServerWith(const Snowflake<Channel>& channelID) {
+			return find(findIndexed(channelServers, channelID).raw());
+		}
+		//old misspelled name
 		inline const_iterator findSeverWith(const Snowflake<Channel>& channelID) {
-			return findOneWithObject(&Server::channels, channelID);
+			return findServerWith(channelID);
 		}
 
 		inline const_iterator findServerWith(const Snowflake<Role> roleID) {
-			return findOneWithObject(&Server::roles, roleID);
+			return find(findIndexed(roleServers, roleID).raw());
 		}
 
-		//Linear time complexity if using list
-		//Usually Constant time complexity if using unordered maps
+		//Note: set the policies before the cache is used, servers already in the cache don't
+		//follow new policies until they are inserted again
+		inline void setPolicies(const Policies& newPolicies) { policies = newPolicies; }
+		inline const Policies& getPolicies() const { return policies; }
+		inline const Counters& getCounters() const { return counters; }
+
+		//add, remove or use an object of a server while following the policies and keeping
+		//the indexes up to date
+		//Note: call these from the callback of accessServer
+		void cacheObject(Server& server, const ServerMember& member);
+		void cacheObject(Server& server, const Channel& channel);
+		void cacheObject(Server& server, const Role& role);
+		void uncacheObject(Server& server, const Snowflake<User>& userID);
+		void uncacheObject(Server& server, const Snowflake<Channel>& channelID);
+		void uncacheObject(Server& server, const Snowflake<Role>& roleID);
+		void useObject(Server& server, const Snowflake<User>& userID);
+		void useObject(Server& server, const Snowflake<Channel>& channelID);
+		void useObject(Server& server, const Snowflake<Role>& roleID);
+		//removes objects that are past their TTL from every server, since objects only
+		//expire on their own when their server is changed
+		void expire();
+		//how often expire should be called, 0 when no policy is TTL
+		time_t getExpireInterval() const;
+
+		//the ids of the servers the user is a member of, as far as the cache knows
+		std::vector<Snowflake<Server>> getServerIDsWith(const Snowflake<User>& userID) const;
+		//Note: the reference is valid until the cache changes, use getServerIDsWith when
+		//other threads can change the cache
+		const ServerIDs& findServersWith(const Snowflake<User>& userID) const;
+
+		//Usually Constant time complexity
 		inline iterator findServer(const Snowflake<Server> serverID) {
 			return serverID.findObject(*this);
 		}
+
+		//call after adding an object to a server in the cache
+		void addToIndex(const Key& serverID, const Channel& channel);
+		void addToIndex(const Key& serverID, const Role& role);
+		void addToIndex(const Key& serverID, const ServerMember& member);
+		void addToIndexes(const Server& server);
+		//call after removing an object from a server in the cache
+		void removeFromIndex(const Key& serverID, const Snowflake<Channel>& channelID);
+		void removeFromIndex(const Key& serverID, const Snowflake<Role>& roleID);
+		void removeFromIndex(const Key& serverID, const Snowflake<User>& userID);
+		void removeFromIndexes(const Server& server);
+		void rebuildIndexes();
+
+		static constexpr std::size_t stripeCount = 64;
+
+	private:
+		using Index = std::unordered_map<Key, Key>;
+		using SharedMutex = std::shared_timed_mutex;
+		using ReadLock = std::shared_lock<SharedMutex>;
+		using WriteLock = std::unique_lock<SharedMutex>;
+
+		//locks are made new when the cache is copied
+		//Note: servers is always locked before a stripe, and a stripe before indexes
+		struct Locks {
+			Locks() = default;
+			Locks(const Locks&) {}
+			Locks& operator=(const Locks&) { return *this; }
+			mutable SharedMutex servers;    //the map of servers itself
+			mutable SharedMutex indexes;
+			mutable std::array<SharedMutex, stripeCount> stripes;
+		};
+
+		inline SharedMutex& getStripe(const Key& serverID) const {
+			return locks.stripes[std::hash<Key>{}(serverID) % stripeCount];
+		}
+
+		template<class Object>
+		Snowflake<Server> findIndexed(const Index& index, const Snowflake<Object>& objectID) const {
+			ReadLock indexesLock(locks.indexes);
+			auto found = index.find(objectID.raw());
+			return found != index.end() ? Snowflake<Server>::fromRaw(found->second) : Snowflake<Server>();
+		}
+
+		//these expect indexes to be locked already
+		void index(const Key& serverID, const Server& server);
+		void unindex(const Key& serverID, const Server& server);
+		void indexObject(const Key& serverID, const Channel& channel);
+		void indexObject(const Key& serverID, const Role& role);
+		void indexObject(const Key& serverID, const ServerMember& member);
+		void unindexObject(const Key& serverID, const Snowflake<Channel>& channelID);
+		void unindexObject(const Key& serverID, const Snowflake<Role>& roleID);
+		void unindexObject(const Key& serverID, const Snowflake<User>& userID);
+
+		struct Trackers {
+			CacheTracker members;
+			CacheTracker channels;
+			CacheTracker roles;
+		};
+
+		//where the policy, counters and so on of a type of object are
+		template<class Object>
+		struct Kind {
+			using ID = decltype(Object::ID);
+			Cache<Object> Server::* container;
+			CachePolicy Policies::* policy;
+			CacheCounters Counters::* counters;
+			CacheTracker Trackers::* tracker;
+		};
+		static const Kind<ServerMember> memberKind;
+		static const Kind<Channel> channelKind;
+		static const Kind<Role> roleKind;
+
+		//these expect the server's stripe to be locked for writing and indexes to be locked
+		template<class Object> void cacheObject(Server& server, const Kind<Object>& kind, const Object& object);
+		template<class Object> void uncacheObject(Server& server, const Kind<Object>& kind, const typename Kind<Object>::ID& ID);
+		template<class Object> void useObject(Server& server, const Kind<Object>& kind, const typename Kind<Object>::ID& ID);
+		template<class Object> void trim(Server& server, const Kind<Object>& kind, CacheTracker& tracker);
+		//for servers being inserted, expects servers and indexes to be locked for writing
+		template<class Object> void applyPolicy(Server& server, const Kind<Object>& kind, Trackers& serverTrackers);
+		void applyPolicies(Server& server);
+		Trackers* findTrackers(const Key& serverID);
+
+		Policies policies;
+		Counters counters;
+		std::unordered_map<Key, Trackers> trackers;
+
+		Index channelServers;
+		Index roleServers;
+		std::unordered_map<Key, ServerIDs> memberServers;
+		Locks locks;
 	};
 
 	struct ServerWidget : public DiscordObject {
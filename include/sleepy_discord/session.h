@@ -16,11 +16,15 @@
 
 	//defaults
 #elif defined(SLEEPY_DISCORD_CMAKE)
-	#if defined(EXISTENT_CPR)
+	#if defined(EXISTENT_CURL)
+		#include "curl_session.h"
+	#elif defined(EXISTENT_CPR)
 		#include "cpr_session.h"
 	#else
 		#include "custom_session.h"
 	#endif
+#elif defined(SLEEPY_USE_CURL)
+	#include "curl_session.h"
 #else
 	#include "cpr_session.h"
 	#ifdef NONEXISTENT_CPR
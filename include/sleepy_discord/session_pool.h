@@ -0,0 +1,80 @@
+#pragma once
+#include <string>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <ctime>
+#include "session.h"
+
+namespace SleepyDiscord {
+	//Keeps sessions alive after a request so that the next request to the same
+	//host can reuse the connection instead of doing a new TCP and TLS handshake
+	class SessionPool {
+	public:
+		struct Settings {
+			std::size_t maxIdleSessions = 8; //per host, extra sessions are destroyed when returned
+			time_t idleTimeout = 60000;      //in milliseconds, sessions unused for longer are evicted
+		};
+
+		//Gives back the session to the pool when destroyed
+		class Handle {
+		public:
+			Handle(SessionPool& _pool, std::string _host, std::unique_ptr<Session> _session) :
+				pool(&_pool), host(std::move(_host)), session(std::move(_session)) {}
+			Handle(Handle&& other) = default;
+			Handle& operator=(Handle&& other) = default;
+			Handle(const Handle&) = delete;
+			Handle& operator=(const Handle&) = delete;
+			~Handle() {
+				if (session)
+					pool->release(host, std::move(session));
+			}
+
+			inline Session& operator*() { return *session; }
+			inline Session* operator->() { return session.get(); }
+
+			//use this when the session is in a state that shouldn't be reused
+			inline void discard() { session.reset(); }
+		private:
+			SessionPool* pool;
+			std::string host;
+			std::unique_ptr<Session> session;
+		};
+
+		SessionPool() = default;
+		SessionPool(Settings _settings) : settings(_settings) {}
+
+		//host is taken from the url, so any url to the same host can be given
+		Handle acquire(const std::string& url);
+		void clear();
+		std::size_t size(); //number of idle sessions
+
+		inline void setSettings(const Settings& newSettings) {
+			std::lock_guard<std::mutex> lock(mutex);
+			settings = newSettings;
+		}
+		inline Settings getSettings() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return settings;
+		}
+
+		static std::string getHost(const std::string& url);
+
+	private:
+		struct IdleSession {
+			std::unique_ptr<Session> session;
+			time_t lastUsed;
+		};
+		using IdleList = std::list<IdleSession>;
+
+		void release(const std::string& host, std::unique_ptr<Session> session);
+		//moves the sessions to expired, mutex needs to be locked before calling
+		void evictIdle(const time_t currentTime, IdleList& expired);
+		static time_t getTime();
+
+		std::unordered_map<std::string, IdleList> idleSessions;
+		Settings settings;
+		std::mutex mutex;
+	};
+}
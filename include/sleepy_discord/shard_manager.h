@@ -0,0 +1,168 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "asio_include.h"
+#include "gateway.h"
+#include "io_thread_pool.h"
+
+namespace SleepyDiscord {
+#ifndef NONEXISTENT_ASIO
+	//Lets shards IDENTIFY at the rate Discord allows
+	//Each shard is in the bucket shardID % max_concurrency, and each bucket gets one IDENTIFY
+	//per interval, so max_concurrency shards can identify at the same time
+	class IdentifyQueue {
+	public:
+		using Identify = std::function<void()>;
+
+		IdentifyQueue(asio::io_service& _io) : io(_io) {}
+		IdentifyQueue(const IdentifyQueue&) = delete;
+		IdentifyQueue& operator=(const IdentifyQueue&) = delete;
+
+		//Note: must be called before push
+		void setBuckets(std::size_t bucketCount, const time_t intervalMilliseconds = 5000);
+		//identify is called from one of the io_service's threads once the shard's bucket is free
+		void push(const int shardID, Identify identify);
+		//no bucket lets a shard identify until then, used when there are no session starts left
+		void delay(const time_t milliseconds);
+		std::size_t getBucketCount() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return buckets.size();
+		}
+
+	private:
+		using Clock = std::chrono::steady_clock;
+		struct Bucket {
+			Bucket(asio::io_service& io) : timer(io) {}
+			std::deque<Identify> waiting;
+			Clock::time_point nextIdentify;
+			bool isWaiting = false;
+			asio::steady_timer timer;
+		};
+
+		void wait(Bucket& bucket);
+		void release(Bucket& bucket);
+
+		asio::io_service& io;
+		std::mutex mutex;
+		std::vector<std::unique_ptr<Bucket>> buckets;
+		std::chrono::milliseconds interval{ 5000 };
+	};
+
+	//Runs every shard of a bot in one process on one io_service
+	//Client needs a constructor that takes the io_service and the token, like
+	//WebsocketppDiscordClient(asio::io_service&, const std::string)
+	template<class Client>
+	class ShardManager {
+	public:
+		struct Settings {
+			int shardCount = 0;                 //0 uses the number of shards Discord recommends
+			time_t identifyInterval = 5000;     //time between IDENTIFYs in the same bucket, in milliseconds
+			IOThreadPool::Settings ioThreads;   //threads shared by all shards
+		};
+		//called for each shard before it connects, for things like setting intents
+		using ShardSetup = std::function<void(Client& shard)>;
+
+		ShardManager(const std::string _token, Settings _settings = {}) :
+			token(_token), settings(_settings), identifyQueue(io) {}
+		ShardManager(const ShardManager&) = delete;
+		ShardManager& operator=(const ShardManager&) = delete;
+
+		//gets the shard count and session start limit from gateway/bot, then connects all shards
+		//blocks until stop is called
+		void run(ShardSetup setup = nullptr) {
+			start(setup);
+			IOThreadPool(settings.ioThreads).run(io);
+		}
+
+		void stop() {
+			std::lock_guard<std::mutex> lock(mutex);
+			for (std::unique_ptr<Client>& shard : shards)
+				shard->quit();
+			work.reset();
+			io.stop();
+		}
+
+		//number of shards that got READY and haven't disconnected since
+		std::size_t getReadyCount() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return static_cast<std::size_t>(std::count_if(shards.begin(), shards.end(),
+				[](const std::unique_ptr<Client>& shard) { return shard->isReady(); }));
+		}
+		bool isReady() {
+			std::size_t count = getShardCount();
+			return count != 0 && getReadyCount() == count;
+		}
+
+		std::size_t getShardCount() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return shards.size();
+		}
+		//Note: shards are made in run, so there are none before that
+		Client& getShard(const int shardID) {
+			std::lock_guard<std::mutex> lock(mutex);
+			return *shards.at(static_cast<std::size_t>(shardID));
+		}
+		//the shard that gets the events of a server
+		Client& getShardFor(const Snowflake<Server> serverID) {
+			std::lock_guard<std::mutex> lock(mutex);
+			const uint64_t id = static_cast<uint64_t>(serverID.number());
+			return *shards.at(static_cast<std::size_t>((id >> 22) % shards.size()));
+		}
+		inline const Gateway& getGateway() { return gateway; }
+		inline asio::io_service& getIOService() { return io; }
+		inline IdentifyQueue& getIdentifyQueue() { return identifyQueue; }
+
+	private:
+		void start(ShardSetup& setup) {
+			std::lock_guard<std::mutex> lock(mutex);
+			work.reset(new asio::io_service::work(io));
+			//the first shard is made early, since requesting gateway/bot needs a client
+			std::unique_ptr<Client> first(new Client(io, token));
+			gateway = first->getGateway();
+
+			const int shardCount = 0 < settings.shardCount ? settings.shardCount :
+				std::max(gateway.shards, 1);
+			const int maxConcurrency = std::max(gateway.sessionStartLimit.maxConcurency, 1);
+			identifyQueue.setBuckets(static_cast<std::size_t>(maxConcurrency), settings.identifyInterval);
+			//each shard uses a session start, so wait for the reset when there aren't enough left
+			if (gateway.sessionStartLimit.remaining < shardCount)
+				identifyQueue.delay(gateway.sessionStartLimit.resetAfter);
+
+			shards.clear();
+			shards.reserve(static_cast<std::size_t>(shardCount));
+			shards.push_back(std::move(first));
+			for (int shardID = 1; shardID < shardCount; ++shardID)
+				shards.emplace_back(new Client(io, token));
+
+			for (int shardID = 0; shardID < shardCount; ++shardID) {
+				Client& shard = *shards[static_cast<std::size_t>(shardID)];
+				shard.setShardID(shardID, shardCount);
+				if (!gateway.url.empty())
+					shard.setGatewayURL(gateway.url);
+				shard.setIdentifyHandler([this, shardID](std::function<void()> identify) {
+					identifyQueue.push(shardID, std::move(identify));
+				});
+				if (setup)
+					setup(shard);
+				shard.BaseDiscordClient::connect();
+			}
+		}
+
+		const std::string token;
+		const Settings settings;
+		asio::io_service io;
+		std::unique_ptr<asio::io_service::work> work;
+		IdentifyQueue identifyQueue;
+		Gateway gateway;
+		std::mutex mutex;
+		//shards use the io_service, so they need to be destroyed first
+		std::vector<std::unique_ptr<Client>> shards;
+	};
+#endif
+}
@@ -2,6 +2,8 @@
 #include <string>
 #include <chrono>
 #include <algorithm>
+#include <type_traits>
+#include <cstdint>
 #if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
 #include <stdexcept>
 #endif
@@ -10,57 +12,139 @@
 
 namespace SleepyDiscord {
 	using Time = int64_t;
+	class DiscordObject;
+
+	//Snowflakes are kept as strings by default, define SLEEPY_NUMERIC_SNOWFLAKE to keep them as
+	//64 bit numbers, which are smaller and faster to compare and hash. They are still strings in json.
+	namespace SnowflakeRaw {
+#ifdef SLEEPY_NUMERIC_SNOWFLAKE
+		using Type = uint64_t;
+		using StringType = std::string;
+
+		//anything that isn't a decimal number that fits in 64 bits is treated as the empty snowflake, 0
+		inline Type parse(const char* data, const std::size_t length) {
+			constexpr std::size_t maxDigits = 20; //digits in UINT64_MAX
+			if (maxDigits < length)
+				return 0;
+			Type number = 0;
+			for (std::size_t i = 0; i < length; ++i) {
+				const unsigned int digit = static_cast<unsigned int>(data[i] - '0');
+				if (9 < digit)
+					return 0;
+				if (number > (UINT64_MAX - digit) / 10)
+					return 0;
+				number = number * 10 + digit;
+			}
+			return number;
+		}
+
+		inline Type fromNumber(const int64_t number) {
+			return static_cast<Type>(number);
+		}
+
+		inline std::string format(Type number) {
+			if (number == 0)
+				return std::string();
+			char digits[20];
+			char* start = digits + sizeof(digits);
+			for (; number != 0; number /= 10)
+				*--start = static_cast<char>('0' + number % 10);
+			return std::string(start, digits + sizeof(digits));
+		}
+#else
+		using Type = std::string;
+		using StringType = const std::string&;
+
+		inline Type parse(const char* data, const std::size_t length) {
+			return std::string(data, length);
+		}
+
+		inline Type fromNumber(const int64_t number) {
+			return std::to_string(number);
+		}
+
+		inline const std::string& format(const Type& raw) {
+			return raw;
+		}
+#endif
+		inline Type parse(const std::string& snow) {
+			return parse(snow.data(), snow.length());
+		}
+	}
 
 	//Stops you from mixing up different types of ids, like using a message_id as a user_id
 	template <typename DiscordObject>
 	struct Snowflake {
-		using RawType = std::string;
+		using RawType = SnowflakeRaw::Type;
 		
 		Snowflake(                                  ) = default;
-		Snowflake(const std::string         & snow  ) : raw( snow                         ) {}
-		Snowflake(const std::string         * snow  ) : raw(*snow                         ) {}
-		Snowflake(const char                * snow  ) : raw( snow                         ) {}
-		Snowflake(const nonstd::string_view & snow  ) : raw(snow.data(), snow.length()    ) {}
-		Snowflake(const Snowflake           & flake ) : Snowflake(flake.string(          )) {}
-		Snowflake(const DiscordObject       & object) : Snowflake(object. ID              ) {}
-		Snowflake(const DiscordObject       * object) : Snowflake(object->ID              ) {}
-		Snowflake(const int64_t               number) : Snowflake(std::to_string(number  )) {}
+		Snowflake(const std::string         & snow  ) : id(SnowflakeRaw::parse(snow)                 ) {}
+		Snowflake(const std::string         * snow  ) : id(SnowflakeRaw::parse(*snow)                ) {}
+		Snowflake(const char                * snow  ) : Snowflake(nonstd::string_view(snow)          ) {}
+		Snowflake(const nonstd::string_view & snow  ) : id(SnowflakeRaw::parse(snow.data(), snow.length())) {}
+		Snowflake(const Snowflake           & flake ) = default;
+		Snowflake(      Snowflake          && flake ) = default;
+		Snowflake(const DiscordObject       & object) : Snowflake(object. ID                         ) {}
+		Snowflake(const DiscordObject       * object) : Snowflake(object->ID                         ) {}
+		Snowflake(const int64_t               number) : id(SnowflakeRaw::fromNumber(number)           ) {}
+		//any type of id can be used where the type isn't known, like application ids
+		template<class OtherObject, typename std::enable_if<
+			std::is_same<DiscordObject, SleepyDiscord::DiscordObject>::value &&
+			!std::is_same<OtherObject, DiscordObject>::value, int>::type = 0>
+		Snowflake(const Snowflake<OtherObject>& flake) : id(flake.raw()) {}
 		Snowflake(const json::Value         & value ) :
-			Snowflake(value.IsString() ? json::toStdString(value) : std::string()) {}
+			id(value.IsString() ? SnowflakeRaw::parse(value.GetString(), value.GetStringLength()) : RawType()) {}
 		~Snowflake() = default;
+		Snowflake& operator=(const Snowflake& ) = default;
+		Snowflake& operator=(      Snowflake&&) = default;
 
 		inline bool operator==(const Snowflake& right) const {
-			return raw == right.raw;
+			return id == right.id;
 		}
 
 		inline bool operator!=(const Snowflake& right) const {
-			return raw != right.raw;
+			return id != right.id;
 		}
 
 		inline bool operator==(const char* right) const {
-			return raw == right;
+			return id == Snowflake(right).id;
 		}
 
 		inline bool operator!=(const char* right) const {
-			return raw != right;
+			return id != Snowflake(right).id;
 		}
 
-		inline operator const std::string&() const { return raw; }
+		inline operator SnowflakeRaw::StringType() const { return SnowflakeRaw::format(id); }
 
-		inline const std::string& string() const { return operator const std::string&(); }
-		inline const int64_t number() const { return std::stoll(raw); }
+		inline SnowflakeRaw::StringType string() const { return SnowflakeRaw::format(id); }
+		//the value used as the key in caches
+		inline const RawType& raw() const { return id; }
+		static inline Snowflake fromRaw(RawType raw) {
+			Snowflake snowflake;
+			snowflake.id = std::move(raw);
+			return snowflake;
+		}
+#ifdef SLEEPY_NUMERIC_SNOWFLAKE
+		inline const int64_t number() const { return static_cast<int64_t>(id); }
+		inline const bool empty() const { return id == 0; }
+#else
+		inline const int64_t number() const { return std::stoll(id); }
+		inline const bool empty() const { return id.empty(); }
+#endif
 
 		std::chrono::time_point<std::chrono::steady_clock> timestamp() const {
 #if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
-			if (raw == "") throw std::invalid_argument("invalid snow in Snowflake");
+			if (empty()) throw std::invalid_argument("invalid snow in Snowflake");
 #endif
-			return std::chrono::time_point<std::chrono::steady_clock>(std::chrono::milliseconds((std::stoll(raw) >> 22) + discordEpoch));
+			return std::chrono::time_point<std::chrono::steady_clock>(std::chrono::milliseconds((number() >> 22) + discordEpoch));
 		}
 
-		inline const bool empty() const { return raw.empty(); }
-
 		inline json::Value serialize(typename json::Value::AllocatorType& alloc) const {
-			return json::ClassTypeHelper<RawType>::fromType(raw, alloc);
+#ifdef SLEEPY_NUMERIC_SNOWFLAKE
+			return json::Value(string().c_str(), alloc);
+#else
+			return json::ClassTypeHelper<RawType>::fromType(id, alloc);
+#endif
 		}
 
 		static inline const bool isType(const typename json::Value& value) {
@@ -76,19 +160,20 @@ namespace SleepyDiscord {
 
 		//Magical code from stackflow
 		//https://stackoverflow.com/a/87846
+		//Containers keyed by the raw snowflake, like Cache, are searched with their find function
 		template<class Container>
 		struct HasAFindFunction {
 			using SuccessType = char;
 			using FailureType = int;
-			template<class _Container, size_t (_Container::*)() const> struct Magic {};
-			template<class _Container> static SuccessType Test(Magic<_Container, &_Container::find>*);
+			template<class _Container> static SuccessType Test(typename std::enable_if<
+				std::is_same<typename _Container::key_type, RawType>::value>::type*);
 			template<class _Container> static FailureType Test(...);
 			static const bool Value = sizeof(Test<Container>(0)) == sizeof(SuccessType);
 		};
 
 		template<class Container>
 		auto findObject(Container& objects, std::true_type) const -> decltype(objects.begin()) {
-			return objects.find(operator const std::string&());
+			return objects.find(id);
 		}
 
 		template<class Container>
@@ -102,23 +187,23 @@ namespace SleepyDiscord {
 		}
 
 	private:
-		RawType raw = {};
+		RawType id = {};
 		static const Time discordEpoch = 1420070400000;	//the first second of 2015 since epoch
 	};
 
 	template <typename DiscordOject>
 	inline std::string operator+(const char * left, Snowflake<DiscordOject>& right) {
-		return left + right.operator const std::string&();
+		return left + right.string();
 	}
 
 	template <typename DiscordOject>
 	inline bool operator==(const char * left, Snowflake<DiscordOject>& right) {
-		return left == right.operator const std::string&().c_str();
+		return right == left;
 	}
 
 	template <typename DiscordOject>
 	inline bool operator!=(const char * left, Snowflake<DiscordOject>& right) {
-		return left != right.operator const std::string&().c_str();
+		return right != left;
 	}
 }
 
@@ -126,7 +211,7 @@ namespace std {
 	template<typename DiscordObject>
 	struct hash<SleepyDiscord::Snowflake<DiscordObject>> {
 		inline size_t operator()(const SleepyDiscord::Snowflake<DiscordObject>& snowflake) const {
-			return std::hash<string>{}(static_cast<const string&>(snowflake));
+			return std::hash<SleepyDiscord::SnowflakeRaw::Type>{}(snowflake.raw());
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,14 @@
+/*
+!!!!!! WARNING !!!!!!
+version.h is an auto generated file. Any changes in version.h while be replaced.
+However, version.h.in, not be confused with version.h, is ok to make changes to.
+*/
+
+#pragma once
+
+#define SLEEPY_DISCORD_VERSION_BUILD 44
+#define SLEEPY_DISCORD_VERSION_BRANCH "master"
+#define SLEEPY_DISCORD_VERSION_HASH "9bf9dc0d0d15bb65efdcc3014e04a9ee5accb2c0"
+#define SLEEPY_DISCORD_VERSION_IS_MASTER 1
+#define SLEEPY_DISCORD_VERSION_DESCRIPTION_CONCAT " "
+#define SLEEPY_DISCORD_VERSION_DESCRIPTION "9bf9dc0"
@@ -10,12 +10,17 @@
 #include "websocketpp_connection.h"
 #include "asio_schedule.h"
 #include "asio_udp.h"
+#include "io_thread_pool.h"
 
 typedef websocketpp::client<websocketpp::config::asio_tls_client> _client;
 
 namespace SleepyDiscord {
 	//typedef GenericMessageReceiver MessageProcssor;
 
+	//each connection's handlers and timers run in its own strand, so that connections can
+	//use more than one io thread without locking their state
+	using ConnectionStrand = asio::io_service::strand;
+
 	class WebsocketppScheduleHandler : public ASIOBasedScheduleHandler {
 	public:
 		WebsocketppScheduleHandler(_client& c) : client(c) {}
@@ -32,20 +37,26 @@ namespace SleepyDiscord {
 	public:
 		WebsocketppDiscordClient() = default;
 		WebsocketppDiscordClient(const std::string token, const char numOfThreads = SleepyDiscord::DEFAULT_THREADS);
+		//for clients that share an io_service, like a ShardManager's shards
+		//Note: the io_service is run by its owner, run and runAsync only connect
+		WebsocketppDiscordClient(asio::io_service& sharedIOService, const std::string token);
 		~WebsocketppDiscordClient();
 
 		using TimerPointer = std::weak_ptr<websocketpp::lib::asio::steady_timer>;
 
 		void run() override;
 		Timer schedule(TimedTask code, const time_t milliseconds) override;
+		//run uses this to run the io_service, numOfThreads is its thread count
+		inline IOThreadPool& getIOThreadPool() { return ioThreads; }
+		//runs on the client's io_service, so on the io threads from run
 		void postTask(PostableTask code) override {
-			asio::post(code);
+			asio::post(this_client.get_io_service(), std::move(code));
 		}
 		//UDPClient createUDPClient() /* override*/;
 	protected:
 #include "standard_config_header.h"
 	private:
-		void init();
+		void init(asio::io_service* sharedIOService = nullptr);
 		bool connect(const std::string & uri,
 			GenericMessageReceiver* messageProcessor,
 			WebsocketConnection& connection
@@ -57,6 +68,7 @@ namespace SleepyDiscord {
 		);
 		void onFail(websocketpp::connection_hdl handle, GenericMessageReceiver* messageProcessor);
 		void send(std::string message, WebsocketConnection& connection) override;
+		void sendBinary(std::string message, WebsocketConnection& connection) override;
 		void runAsync() override;
 		void onOpen(websocketpp::connection_hdl hdl, GenericMessageReceiver* messageProcessor);
 		void onMessage(
@@ -66,9 +78,14 @@ namespace SleepyDiscord {
 		);
 		void stopClient() override {
 			this_client.stop_perpetual();
-			this_client.stop();
+			//stopping a shared io_service would stop the other clients too
+			if (ownsIOService)
+				this_client.stop();
 		}
 		_client this_client;
+		bool ownsIOService = true;
+		IOThreadPool ioThreads;
+		std::shared_ptr<ConnectionStrand> gatewayStrand;
 		websocketpp::lib::shared_ptr<websocketpp::lib::thread> _thread;
 		websocketpp::connection_hdl handle;
 	};
@@ -0,0 +1,58 @@
+#pragma once
+#include "generic_compression.h"
+#ifdef EXISTENT_ZSTD
+	#include <zstd.h>
+#endif
+#include <string>
+#include <mutex>
+
+namespace SleepyDiscord {
+#ifdef EXISTENT_ZSTD
+	//zstd-stream transport compression
+	//Discord sends one zstd stream for the whole connection, where every websocket
+	//message ends with a flush, so each message uncompresses to a full gateway message
+	class ZstdCompression : public GenericCompression {
+	public:
+		ZstdCompression();
+		~ZstdCompression();
+		ZstdCompression(const ZstdCompression&) = delete;
+		ZstdCompression& operator=(const ZstdCompression&) = delete;
+
+		ZSTD_DStream* stream;
+		std::size_t statusCode = 0; //result of the last ZSTD_decompressStream call
+
+		CompressionOutput output; //uncompressed data goes straight in here
+		std::mutex mutex; //only allow one thread to uncompress
+
+		void uncompress(const std::string& compressed) override;
+		void getOutput(std::string& uncompressedOut) override;
+
+		inline void resetStream() override {
+			std::lock_guard<std::mutex> lock(mutex);
+			ZSTD_DCtx_reset(stream, ZSTD_reset_session_only);
+			statusCode = 0;
+			output.size = 0;
+		}
+
+		inline bool streamEnded() override {
+			return statusCode == 0;
+		}
+
+		inline bool hasFailed() override {
+			return ZSTD_isError(statusCode) != 0;
+		}
+
+		const char* getTransportName() const override {
+			return "zstd-stream";
+		}
+		bool isEndOfMessage(const std::string& /*compressed*/) const override {
+			return true;
+		}
+	};
+
+	#ifndef SLEEPY_DEFAULT_COMPRESSION
+	using DefaultCompression = ZstdCompression;
+	#define SLEEPY_DEFAULT_COMPRESSION ZstdCompression
+	#endif
+#endif
+}
@@ -0,0 +1,207 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "cache_snapshot.h"
+#include "etf.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define SLEEPY_USE_MMAP
+#endif
+
+namespace SleepyDiscord {
+	namespace CacheSnapshot {
+		namespace {
+			constexpr char magic[8] = { 'S', 'L', 'E', 'E', 'P', 'Y', 'S', 'C' };
+
+			inline void writeUInt32(std::string& out, const uint32_t number) {
+				for (int shift = 24; 0 <= shift; shift -= 8)
+					out += static_cast<char>((number >> shift) & 0xFF);
+			}
+
+			//appends the ETF term of object with its length in front
+			template<class Object>
+			void writeTerm(std::string& out, const Object& object) {
+				const std::size_t lengthPosition = out.length();
+				writeUInt32(out, 0);
+				ETF::encode(json::toJSON(object), out);
+				const uint32_t length = static_cast<uint32_t>(out.length() - lengthPosition - 4);
+				for (int i = 0; i < 4; ++i)
+					out[lengthPosition + i] = static_cast<char>((length >> (24 - i * 8)) & 0xFF);
+			}
+
+			//the file's contents, mapped into memory when the platform can do that
+			class MappedFile {
+			public:
+				MappedFile(const std::string& path) {
+#if defined(_WIN32)
+					file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+						OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+					if (file == INVALID_HANDLE_VALUE)
+						return;
+					LARGE_INTEGER fileSize;
+					if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+						return;
+					mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+					if (mapping == nullptr)
+						return;
+					const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+					if (view == nullptr)
+						return;
+					contents = static_cast<const char*>(view);
+					length = static_cast<std::size_t>(fileSize.QuadPart);
+#elif defined(SLEEPY_USE_MMAP)
+					file = open(path.c_str(), O_RDONLY);
+					if (file == -1)
+						return;
+					struct stat status;
+					if (fstat(file, &status) != 0 || status.st_size == 0)
+						return;
+					void* view = mmap(nullptr, static_cast<std::size_t>(status.st_size),
+						PROT_READ, MAP_PRIVATE, file, 0);
+					if (view == MAP_FAILED)
+						return;
+					//the file is read from start to end once
+					madvise(view, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+					contents = static_cast<const char*>(view);
+					length = static_cast<std::size_t>(status.st_size);
+#else
+					std::ifstream stream(path, std::ios::binary);
+					if (!stream)
+						return;
+					buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+					contents = buffer.data();
+					length = buffer.length();
+#endif
+				}
+
+				~MappedFile() {
+#if defined(_WIN32)
+					if (contents != nullptr)
+						UnmapViewOfFile(contents);
+					if (mapping != nullptr)
+						CloseHandle(mapping);
+					if (file != INVALID_HANDLE_VALUE)
+						CloseHandle(file);
+#elif defined(SLEEPY_USE_MMAP)
+					if (contents != nullptr)
+						munmap(const_cast<char*>(contents), length);
+					if (file != -1)
+						close(file);
+#endif
+				}
+
+				MappedFile(const MappedFile&) = delete;
+				MappedFile& operator=(const MappedFile&) = delete;
+
+				inline const char* data() const { return contents; }
+				inline std::size_t size() const { return length; }
+
+			private:
+				const char* contents = nullptr;
+				std::size_t length = 0;
+#if defined(_WIN32)
+				HANDLE file = INVALID_HANDLE_VALUE;
+				HANDLE mapping = nullptr;
+#elif defined(SLEEPY_USE_MMAP)
+				int file = -1;
+#else
+				std::string buffer;
+#endif
+			};
+
+			struct Reader {
+				const char* position;
+				const char* const end;
+
+				inline bool has(const std::size_t count) const {
+					return count <= static_cast<std::size_t>(end - position);
+				}
+
+				bool readUInt32(uint32_t& number) {
+					if (!has(4))
+						return false;
+					number = 0;
+					for (int i = 0; i < 4; ++i)
+						number = (number << 8) | static_cast<unsigned char>(*position++);
+					return true;
+				}
+
+				//decodes the next term into document, the document's memory is reused
+				bool readTerm(rapidjson::Document& document) {
+					uint32_t length;
+					if (!readUInt32(length) || !has(length))
+						return false;
+					document.SetNull();
+					document.GetAllocator().Clear();
+					const bool isDecoded = ETF::decode(position, length, document, document.GetAllocator());
+					position += length;
+					return isDecoded;
+				}
+			};
+		}
+
+		bool save(const std::string& path, const ServerCache& cache, const GatewaySession& session) {
+			std::string out;
+			out.append(magic, sizeof(magic));
+			writeUInt32(out, VERSION);
+			writeTerm(out, session);
+			const std::size_t countPosition = out.length();
+			writeUInt32(out, 0);
+			uint32_t serverCount = 0;
+			cache.readServers([&out, &serverCount](const Server& server) {
+				writeTerm(out, server);
+				++serverCount;
+			});
+			for (int i = 0; i < 4; ++i)
+				out[countPosition + i] = static_cast<char>((serverCount >> (24 - i * 8)) & 0xFF);
+
+			//written to another file first, so that a crash can't leave half a snapshot
+			const std::string temporaryPath = path + ".tmp";
+			{
+				std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+				if (!file)
+					return false;
+				file.write(out.data(), static_cast<std::streamsize>(out.length()));
+				if (!file)
+					return false;
+			}
+#if defined(_WIN32)
+			std::remove(path.c_str()); //rename doesn't replace files on Windows
+#endif
+			return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+		}
+
+		bool load(const std::string& path, ServerCache& cache, GatewaySession* session) {
+			MappedFile file(path);
+			if (file.data() == nullptr || file.size() < sizeof(magic) ||
+				std::memcmp(file.data(), magic, sizeof(magic)) != 0)
+				return false;
+			Reader reader{ file.data() + sizeof(magic), file.data() + file.size() };
+
+			uint32_t version;
+			if (!reader.readUInt32(version) || version != VERSION)
+				return false;
+			rapidjson::Document document;
+			if (!reader.readTerm(document))
+				return false;
+			if (session != nullptr)
+				*session = GatewaySession(static_cast<const json::Value&>(document));
+
+			uint32_t serverCount;
+			if (!reader.readUInt32(serverCount))
+				return false;
+			for (uint32_t i = 0; i < serverCount; ++i) {
+				if (!reader.readTerm(document))
+					return false;
+				cache.insert(Server(static_cast<const json::Value&>(document)));
+			}
+			return true;
+		}
+	}
+}
@@ -4,11 +4,13 @@
 
 #include <chrono>
 #include <functional>
-#include <sstream>
-#include <iomanip>
 #include <ctime>
 #include <cstring>
+#include <cstdlib>
+#include <unordered_set>
 #include "client.h"
+#include "cache_snapshot.h"
+#include "json_sax.h"
 #include "version_helper.h"
 //#include "json.h"
 #include "rapidjson/document.h"
@@ -25,7 +27,9 @@ namespace SleepyDiscord {
 		
 		ready = false;
 		quiting = false;
-		bot = true;
+		//a session from resumeSession already knows if it's a bot
+		if (sessionID.empty())
+			bot = true;
 		setToken(_token);
 		if (_shardID != 0 || _shardCount != 0)
 			setShardID(_shardID, _shardCount);
@@ -36,6 +40,7 @@ namespace SleepyDiscord {
 	BaseDiscordClient::~BaseDiscordClient() {
 		ready = false;
 		if (heart.isValid()) heart.stop();
+		if (cacheExpireTimer.isValid()) cacheExpireTimer.stop();
 		stopReconnecting();
 	}
 
@@ -48,162 +53,224 @@ namespace SleepyDiscord {
 		response.birth = currentTime;
 		Route::Bucket bucket = path.bucket(method);
 
-		bool shouldCallCallback = true;
-		const auto handleCallbackCall = [&]() {
-			if (shouldCallCallback && callback)
-				callback(response);
-		};
-		const auto handleExceededRateLimit = [=, &shouldCallCallback](std::time_t timeTilRetry) {
+		const time_t nextTry = rateLimiter.acquire(bucket, currentTime);
+		if (0 < nextTry) {
+			bool shouldContinueRequest = true;
 			onExceededRateLimit(
-				rateLimiter.isGlobalRateLimited, timeTilRetry,
+				rateLimiter.isGlobalRateLimited, nextTry - currentTime,
 				{ *this, method, path, jsonParameters, multipartParameters, callback, mode },
-				shouldCallCallback
+				shouldContinueRequest
 			);
-		};
-
-		time_t nextTry = rateLimiter.getLiftTime(bucket, currentTime);
-		if (0 < nextTry) {
-			handleExceededRateLimit(nextTry - currentTime);
-			response.statusCode = TOO_MANY_REQUESTS;
-			onError(TOO_MANY_REQUESTS,
-				"Too many request going to " +
-					std::string(getMethodName(method)) + " " +
-					path.url());
-			handleCallbackCall();
-			return response;
+			//when the request was queued, it's made later
+			if (!shouldContinueRequest) {
+				response.statusCode = TOO_MANY_REQUESTS;
+				return response;
+			}
+			//otherwise, wait for the rate limit to lift instead of failing
+			rateLimiter.wait(bucket);
+			return performRequest(method, path, bucket, jsonParameters, multipartParameters, callback, mode, getEpochTimeMillisecond());
 		}
+		return performRequest(method, path, bucket, jsonParameters, multipartParameters, callback, mode, currentTime);
+	}
+
+	Response BaseDiscordClient::performRequest(const RequestMethod method, const Route& path, const Route::Bucket& bucket,
+		const std::string& jsonParameters, const std::vector<Part>& multipartParameters,
+		const RequestCallback& callback, const RequestMode mode, const time_t currentTime
+	) {
+		Response response;
+		response.birth = currentTime;
 		{	//the { is used so that onResponse is called after session is removed to make debugging performance issues easier
 			//request starts here
-			Session session;
-			session.setUrl("https://discord.com/api/v8/" + path.url());
-			std::vector<HeaderPair> header = {
-				{ "Authorization", bot ? "Bot " + getToken() : getToken() },
-				{ "User-Agent", userAgent },
-			};
-			if (jsonParameters != "") {
-				session.setBody(&jsonParameters);
-				header.push_back({ "Content-Type"  , "application/json"                      });
-				header.push_back({ "Content-Length", std::to_string(jsonParameters.length()) });
-			} else if (0 < multipartParameters.size()) {
-				session.setMultipart(multipartParameters);
+			static constexpr char baseURL[] = "https://discord.com/api/v8/";
+			//reused so that building the url doesn't need to allocate
+			thread_local std::string url;
+			url.assign(baseURL, sizeof(baseURL) - 1);
+			url += path.url();
+			SessionPool::Handle session = sessionPool.acquire(url);
+			session->setUrl(url);
+
+			//async requests outlive this function, so they keep a copy of the request
+			std::shared_ptr<Request> asyncRequest;
+#ifdef SLEEPY_CURL_MULTI
+			CurlMulti* multi = static_cast<int>(mode) & static_cast<int>(UseRequestAsync) ?
+				getCurlMulti() : nullptr;
+			session->setMulti(multi);
+			if (multi)
+				asyncRequest = std::make_shared<Request>(
+					Request{ *this, method, path, jsonParameters, multipartParameters, callback, mode });
+#endif
+			const std::string& body = asyncRequest ? asyncRequest->jsonParameters : jsonParameters;
+
+			const AuthHeaders auth = std::atomic_load(&authHeaders);
+			std::vector<HeaderPair> header;
+			if (auth) {
+				header.reserve(auth->size() + 2);
+				for (const HeaderPair& pair : *auth)
+					header.push_back(pair);
+			}
+			const bool isMultipart = body.empty() && 0 < multipartParameters.size();
+			if (isMultipart) {
+				session->setMultipart(multipartParameters);
 				header.push_back({ "Content-Type", "multipart/form-data" });
 			} else {
-				header.push_back({ "Content-Length", "0" });
+				//always set the body, so that a body from the session's last request isn't sent again
+				session->setBody(&body);
+				if (!body.empty())
+					header.push_back({ "Content-Type", "application/json" });
+				header.push_back({ "Content-Length", std::to_string(body.length()) });
 			}
-			session.setHeader(header);
+			session->setHeader(header);
 
 			//Do the response
 			switch (method) {
 			case Post: case Patch: case Delete: case Get: case Put:
-				response = session.request(method);
+				if (asyncRequest) {
+					//the session is kept out of the pool until the callback is done with it
+					auto sessionHandle = std::make_shared<SessionPool::Handle>(std::move(session));
+					(*sessionHandle)->setResponseCallback(
+						[this, asyncRequest, bucket, sessionHandle, isMultipart, currentTime](Response asyncResponse) {
+							asyncResponse.birth = currentTime;
+							if (isMultipart || asyncResponse.statusCode == 0)
+								sessionHandle->discard();
+							const Request& request = *asyncRequest;
+							handleResponse(request.method, request.url, bucket, request.jsonParameters,
+								request.multipartParameters, request.callback, request.mode, asyncResponse);
+							onResponse(asyncResponse);
+						}
+					);
+					(*sessionHandle)->request(method);
+					return response;
+				}
+				response = session->request(method);
 				break;
 			default: response.statusCode = BAD_REQUEST; break; //unexpected method
 			}
 
-			//rate limit check
-			if (response.header["X-RateLimit-Remaining"] == "0" && response.statusCode != TOO_MANY_REQUESTS) {
-				std::tm date = {};
-				//for some reason std::get_time requires gcc 5
-				std::istringstream dateStream(response.header["Date"]);
-				dateStream >> std::get_time(&date, "%a, %d %b %Y %H:%M:%S GMT");
-				const double resetTime = std::stod(response.header["X-RateLimit-Reset"]);
-				const time_t reset = time_t(resetTime) + 1; //add one second for lost precision
-				const std::string& xBucket = response.header["X-RateLimit-Bucket"];
-#if defined(_WIN32) || defined(_WIN64)
-				std::tm gmTM;
-				std::tm* const resetGM = &gmTM;
-				gmtime_s(resetGM, &reset);
-#elif defined(__STDC_LIB_EXT1__)
-				std::tm gmTM;
-				std::tm* resetGM = &gmTM;
-				gmtime_s(&reset, resetGM);
-#else
-				std::tm* resetGM = std::gmtime(&reset);
-#endif
-				const time_t resetDelta = (std::mktime(resetGM) - std::mktime(&date)) * 1000;
-				rateLimiter.limitBucket(bucket, xBucket, resetDelta + getEpochTimeMillisecond());
-				onDepletedRequestSupply(bucket, resetDelta);
-			}
+			//multipart can't be unset and status code 0 means the connection failed,
+			//so don't give those sessions back to the pool
+			if (isMultipart || response.statusCode == 0)
+				session.discard();
+		}
+		handleResponse(method, path, bucket, jsonParameters, multipartParameters, callback, mode, response);
+		onResponse(response);
+		return response;
+	}
 
-			//status checking
-			switch (response.statusCode) {
-			case OK: case CREATED: case NO_CONTENT: case NOT_MODIFIED: break;
-			case TOO_MANY_REQUESTS:
-				{   //this should fall down to default
-					std::string rawRetryAfter = response.header["Retry-After"];
-					//the 5 is an arbitrary number, and there's 1000 ms in a second
-					int retryAfter = rawRetryAfter != "" ? std::stoi(rawRetryAfter) : 5;
-					retryAfter *= 1000; //convert to milliseconds
-					rateLimiter.isGlobalRateLimited = response.header.find("X-RateLimit-Global") != response.header.end();
-					rateLimiter.nextRetry = getEpochTimeMillisecond() + retryAfter;
-					const std::string& xBucket = response.header["X-RateLimit-Bucket"];
-					if (!rateLimiter.isGlobalRateLimited) {
-						rateLimiter.limitBucket(bucket, xBucket, rateLimiter.nextRetry);
-						onDepletedRequestSupply(bucket, retryAfter);
-					}
-					handleExceededRateLimit(retryAfter);
+	void BaseDiscordClient::handleResponse(const RequestMethod method, const Route& path, const Route::Bucket& bucket,
+		const std::string& jsonParameters, const std::vector<Part>& multipartParameters,
+		const RequestCallback& callback, const RequestMode mode, Response& response
+	) {
+		bool shouldCallCallback = true;
+		const auto handleExceededRateLimit = [&](std::time_t timeTilRetry) {
+			onExceededRateLimit(
+				rateLimiter.isGlobalRateLimited, timeTilRetry,
+				{ *this, method, path, jsonParameters, multipartParameters, callback, mode },
+				shouldCallCallback
+			);
+		};
+
+		//rate limit check
+		const auto xBucket = response.header.find("X-RateLimit-Bucket");
+		const auto xRemaining = response.header.find("X-RateLimit-Remaining");
+		if (xBucket != response.header.end() && xRemaining != response.header.end()) {
+			const auto xLimit = response.header.find("X-RateLimit-Limit");
+			const auto xResetAfter = response.header.find("X-RateLimit-Reset-After");
+			const int limit = xLimit != response.header.end() ? std::atoi(xLimit->second.c_str()) : 1;
+			const int remaining = std::atoi(xRemaining->second.c_str());
+			//Reset-After is in seconds with millisecond precision
+			const time_t resetAfter = xResetAfter != response.header.end() ?
+				static_cast<time_t>(std::strtod(xResetAfter->second.c_str(), nullptr) * 1000 + 0.5) : 1000;
+			const bool isDepleted = rateLimiter.update(bucket, xBucket->second,
+				limit, remaining, resetAfter, getEpochTimeMillisecond());
+			if (isDepleted)
+				onDepletedRequestSupply(bucket, resetAfter);
+		} else {
+			rateLimiter.finish(bucket, getEpochTimeMillisecond());
+		}
+
+		//status checking
+		switch (response.statusCode) {
+		case OK: case CREATED: case NO_CONTENT: case NOT_MODIFIED: break;
+		case TOO_MANY_REQUESTS:
+			{   //this should fall down to default
+				const auto rawRetryAfter = response.header.find("Retry-After");
+				//the 5 is an arbitrary number, and there's 1000 ms in a second
+				const time_t retryAfter = rawRetryAfter != response.header.end() ?
+					static_cast<time_t>(std::strtod(rawRetryAfter->second.c_str(), nullptr) * 1000) : 5000;
+				const time_t retryTime = getEpochTimeMillisecond() + retryAfter;
+				if (response.header.find("X-RateLimit-Global") != response.header.end()) {
+					rateLimiter.limitGlobal(retryTime);
+				} else {
+					rateLimiter.limitBucket(bucket,
+						xBucket != response.header.end() ? xBucket->second : "",
+						retryTime);
+					onDepletedRequestSupply(bucket, retryAfter);
 				}
-			default:
-				{		//error
-					const ErrorCode code = static_cast<ErrorCode>(response.statusCode);
-					setError(code);		//https error
-					if (!response.text.empty()) {
-						//json::Values values = json::getValues(response.text.c_str(),
-						//{ "code", "message" });	//parse json to get code and message
-						rapidjson::Document document;
-						document.Parse(response.text.c_str());
-						if (!document.IsObject()) {
-							onError(GENERAL_ERROR, "No error code or message from Discord");
-							break;
-						}
+				handleExceededRateLimit(retryAfter);
+			}
+		default:
+			{		//error
+				const ErrorCode code = static_cast<ErrorCode>(response.statusCode);
+				setError(code);		//https error
+				if (!response.text.empty()) {
+					//json::Values values = json::getValues(response.text.c_str(),
+					//{ "code", "message" });	//parse json to get code and message
+					rapidjson::Document document;
+					json::parse(document, response.text.data(), response.text.length(), response.text.capacity());
+					if (!document.IsObject()) {
+						onError(GENERAL_ERROR, "No error code or message from Discord");
+						break;
+					}
 
-						auto errorCode = document.FindMember("code");
-						auto errorMessage = document.FindMember("message");
-						if (errorCode != static_cast<rapidjson::GenericValue<rapidjson::UTF8<>>::ConstMemberIterator>(document.MemberEnd())){
-							std::size_t fullErrorMessageSize = 0;
-							fullErrorMessageSize += path.getPath().length();
-							fullErrorMessageSize += 1;
-							fullErrorMessageSize += response.text.length();
-							fullErrorMessageSize += 1;
-							std::string message = (
-									errorMessage != static_cast<rapidjson::GenericValue<rapidjson::UTF8<>>::ConstMemberIterator>(document.MemberEnd())
-									?
-										errorMessage->value.GetString()
-									:
-										""
-							);
-							fullErrorMessageSize += message.length();
-							std::string fullErrorMessage;
-							fullErrorMessage.reserve(fullErrorMessageSize);
-							fullErrorMessage += path.getPath();
-							fullErrorMessage += '\n';
-							fullErrorMessage += response.text;
-							fullErrorMessage += '\n';
-							fullErrorMessage += message;
-
-							onError(
-								static_cast<ErrorCode>(errorCode->value.GetInt()),
-								std::move(fullErrorMessage)
-							);
-						} else if (!response.text.empty()) {
-							onError(ERROR_NOTE, response.text);
-						}
+					auto errorCode = document.FindMember("code");
+					auto errorMessage = document.FindMember("message");
+					if (errorCode != static_cast<rapidjson::GenericValue<rapidjson::UTF8<>>::ConstMemberIterator>(document.MemberEnd())){
+						std::size_t fullErrorMessageSize = 0;
+						fullErrorMessageSize += path.getPath().length();
+						fullErrorMessageSize += 1;
+						fullErrorMessageSize += response.text.length();
+						fullErrorMessageSize += 1;
+						std::string message = (
+								errorMessage != static_cast<rapidjson::GenericValue<rapidjson::UTF8<>>::ConstMemberIterator>(document.MemberEnd())
+								?
+									errorMessage->value.GetString()
+								:
+									""
+						);
+						fullErrorMessageSize += message.length();
+						std::string fullErrorMessage;
+						fullErrorMessage.reserve(fullErrorMessageSize);
+						fullErrorMessage += path.getPath();
+						fullErrorMessage += '\n';
+						fullErrorMessage += response.text;
+						fullErrorMessage += '\n';
+						fullErrorMessage += message;
+
+						onError(
+							static_cast<ErrorCode>(errorCode->value.GetInt()),
+							std::move(fullErrorMessage)
+						);
+					} else if (!response.text.empty()) {
+						onError(ERROR_NOTE, response.text);
 					}
+				}
 #if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
-							if (static_cast<int>(mode) & static_cast<int>(ThrowError))
-								throw code;
+						if (static_cast<int>(mode) & static_cast<int>(ThrowError))
+							throw code;
 #endif
-				} break;
-			}
-
-			handleCallbackCall();
+			} break;
 		}
-		onResponse(response);
-		return response;
+
+		if (shouldCallCallback && callback)
+			callback(response);
 	}
 
 	const Route BaseDiscordClient::path(const char * source, std::initializer_list<std::string> values) {
-		return Route(source, values);
+		return Route(std::string(source), values);
+	}
+
+	const Route BaseDiscordClient::path(const RouteTemplate& route, std::initializer_list<std::string> values) {
+		return Route(route, values);
 	}
 
 	std::shared_ptr<ServerCache> BaseDiscordClient::createServerCache() {
@@ -211,23 +278,90 @@ namespace SleepyDiscord {
 		return getServerCache();
 	}
 
+	bool BaseDiscordClient::saveCacheSnapshot(const std::string& path) {
+		return serverCache && CacheSnapshot::save(path, *serverCache, getSession());
+	}
+
+	bool BaseDiscordClient::loadCacheSnapshot(const std::string& path) {
+		std::shared_ptr<ServerCache> cache = serverCache ? serverCache : std::make_shared<ServerCache>();
+		GatewaySession session;
+		if (!CacheSnapshot::load(path, *cache, &session))
+			return false;
+		serverCache = cache;
+		if (!session.empty())
+			resumeSession(session);
+		if (ready)
+			startCacheExpiry();
+		return true;
+	}
+
+	std::shared_ptr<PermissionCache> BaseDiscordClient::createPermissionCache() {
+		setPermissionCache(std::make_shared<PermissionCache>());
+		return getPermissionCache();
+	}
+
+	std::shared_ptr<MessageCache> BaseDiscordClient::createMessageCache(MessageCache::Settings settings) {
+		setMessageCache(std::make_shared<MessageCache>(settings));
+		return getMessageCache();
+	}
+
 	void BaseDiscordClient::setServerCache(std::shared_ptr<ServerCache> cache) {
 		serverCache = cache;
 		if ((ready || !isBot()) && serverCache->size() == 0)
 			*serverCache = getServers().get<Cache>();
+		//before ready, READY starts it, so that policies set after this are used
+		if (ready)
+			startCacheExpiry();
+	}
+
+	void BaseDiscordClient::startCacheExpiry() {
+		if (!serverCache || cacheExpireTimer.isValid())
+			return;
+		expireCache();
+	}
+
+	void BaseDiscordClient::removeStaleServers(const std::list<UnavailableServer>& servers) {
+		std::unordered_set<ServerCache::Key> current;
+		for (const UnavailableServer& server : servers)
+			current.insert(server.ID.raw());
+		//the cache could be shared with other shards, so their servers are left alone
+		const auto isInShard = [this](const Snowflake<Server>& serverID) {
+			return shardCount <= 1 ||
+				(static_cast<uint64_t>(serverID.number()) >> 22) % shardCount == static_cast<uint64_t>(shardID);
+		};
+		std::vector<Snowflake<Server>> stale;
+		serverCache->readServers([&](const Server& server) {
+			if (isInShard(server.ID) && current.find(server.ID.raw()) == current.end())
+				stale.push_back(server.ID);
+		});
+		for (const Snowflake<Server>& serverID : stale) {
+			serverCache->erase(serverID);
+			if (permissionCache)
+				permissionCache->eraseServer(serverID);
+		}
+	}
+
+	void BaseDiscordClient::expireCache() {
+		//policies can change, so this keeps checking without a TTL policy
+		constexpr time_t checkInterval = 60000;
+		const std::shared_ptr<ServerCache> cache = serverCache;
+		const time_t interval = cache ? cache->getExpireInterval() : 0;
+		if (interval != 0)
+			cache->expire();
+		cacheExpireTimer = schedule(&BaseDiscordClient::expireCache, interval != 0 ? interval : checkInterval);
 	}
 
 	void BaseDiscordClient::onDepletedRequestSupply(const Route::Bucket&, time_t) {
 	}
 
-	void BaseDiscordClient::onExceededRateLimit(bool, std::time_t timeTilRetry, Request request, bool& continueRequest) {
+	void BaseDiscordClient::onExceededRateLimit(bool, std::time_t, Request request, bool& continueRequest) {
 		bool shouldScheduleNewRequest =
 			static_cast<int>(request.mode) & static_cast<int>(AsyncQueue);
 		continueRequest = !shouldScheduleNewRequest;
 		if (shouldScheduleNewRequest) {
-			//since we are scheduling the request, I think we should make it async
+			//since we are queuing the request, I think we should make it async
 			request.mode = Async;
-			schedule(request, timeTilRetry);
+			rateLimiter.enqueue(request.url.bucket(request.method), std::move(request), getEpochTimeMillisecond());
 		}
 	}
 
@@ -267,11 +401,48 @@ namespace SleepyDiscord {
 		while (!ready) sleep(1000);
 	}
 
+#ifdef SLEEPY_CURL_MULTI
+	CurlMulti* BaseDiscordClient::getCurlMulti() {
+		std::call_once(curlMultiFlag, [this]() {
+			ASIOBasedScheduleHandler* handler = dynamic_cast<ASIOBasedScheduleHandler*>(scheduleHandler.get());
+			if (handler != nullptr)
+				curlMulti.reset(new CurlMulti(handler->getIOService()));
+		});
+		return curlMulti.get();
+	}
+
+#endif
+	void BaseDiscordClient::updateAuthHeaders() {
+		const std::string& rawToken = token ? *token : std::string();
+		AuthHeaders headers = std::make_shared<const std::vector<HeaderPair>>(std::vector<HeaderPair>{
+			{ "Authorization", bot ? "Bot " + rawToken : rawToken },
+			{ "User-Agent", userAgent },
+		});
+		std::atomic_store(&authHeaders, std::move(headers));
+	}
+
 	void BaseDiscordClient::setShardID(int _shardID, int _shardCount) {
 		shardID = _shardID;
 		shardCount = _shardCount;
 	}
 
+	GatewaySession BaseDiscordClient::getSession() {
+		GatewaySession session;
+		session.sessionID = sessionID;
+		session.sequence = lastSReceived;
+		session.userID = userID;
+		session.bot = bot;
+		return session;
+	}
+
+	void BaseDiscordClient::resumeSession(const GatewaySession& session) {
+		sessionID = session.sessionID;
+		lastSReceived = session.sequence;
+		userID = session.userID;
+		bot = session.bot;
+		updateAuthHeaders();
+	}
+
 	void BaseDiscordClient::getTheGateway() {
 #ifdef SLEEPY_USE_HARD_CODED_GATEWAY
 	#ifndef SLEEPY_HARD_CODED_GATEWAY
@@ -279,32 +450,58 @@ namespace SleepyDiscord {
 	#endif
 		theGateway = SLEEPY_HARD_CODED_GATEWAY;	//This is needed for when session is disabled
 #else
-		Session session;
-		session.setUrl("https://discord.com/api/gateway");
-		Response a = session.request(Get);	//todo change this back to a post
-		if (!a.text.length()) {	//error check
-			quit(false, true);
-			return setError(GATEWAY_FAILED);
-		}
-		if (!theGateway.empty())
-			theGateway.clear();
-		//getting the gateway
-		for (unsigned int position = 0, j = 0; ; ++position) {
-			if (a.text[position] == '"')
-				++j;
-			else if (j == 3) {
-				const unsigned int start = position;
-				while (a.text[++position] != '"');
-				unsigned int size = position - start;
-				theGateway.reserve(32);
-				theGateway.append(a.text, start, size);
-				theGateway += "/?v=8";
-				break;
+		if (!gatewayURL.empty()) {
+			theGateway = gatewayURL + "/?v=8";
+		} else {
+			const std::string url = "https://discord.com/api/gateway";
+			SessionPool::Handle session = sessionPool.acquire(url);
+			const std::string emptyBody;
+			session->setUrl(url);
+			session->setBody(&emptyBody);
+			const AuthHeaders auth = std::atomic_load(&authHeaders);
+			session->setHeader(auth ? *auth : std::vector<HeaderPair>{});
+			Response a = session->request(Get);	//todo change this back to a post
+			if (!a.text.length()) {	//error check
+				quit(false, true);
+				return setError(GATEWAY_FAILED);
+			}
+			if (!theGateway.empty())
+				theGateway.clear();
+			//getting the gateway
+			for (unsigned int position = 0, j = 0; ; ++position) {
+				if (a.text[position] == '"')
+					++j;
+				else if (j == 3) {
+					const unsigned int start = position;
+					while (a.text[++position] != '"');
+					unsigned int size = position - start;
+					theGateway.reserve(32);
+					theGateway.append(a.text, start, size);
+					theGateway += "/?v=8";
+					break;
+				}
 			}
 		}
 #endif
-		if (useTrasportConnection == 1)
-			theGateway += "&compress=zlib-stream";
+		if (gatewayEncoding == GatewayEncoding::ETF)
+			theGateway += "&encoding=etf";
+		if (useTrasportConnection == 1 && compressionHandler) {
+			theGateway += "&compress=";
+			theGateway += compressionHandler->getTransportName();
+		}
+	}
+
+	void BaseDiscordClient::identify() {
+		if (!identifyHandler)
+			return sendIdentity();
+		const unsigned int request = ++identifyRequest;
+		identifyHandler([this, request]() {
+			//go back to the connection's thread before identifying
+			schedule([this, request]() {
+				if (request == identifyRequest)
+					sendIdentity();
+			}, 0);
+		});
 	}
 
 	void BaseDiscordClient::sendIdentity() {
@@ -396,8 +593,11 @@ namespace SleepyDiscord {
 
 #ifdef SLEEPY_VOICE_ENABLED
 		//quit all voice connections
-		for (VoiceConnection& voiceConnection : voiceConnections)
-			voiceConnection.disconnect();
+		{
+			std::lock_guard<std::mutex> lock(voiceMutex);
+			for (VoiceConnection& voiceConnection : voiceConnections)
+				voiceConnection.disconnect();
+		}
 #endif
 		if (heart.isValid()) heart.stop(); //stop heartbeating
 		stopReconnecting();
@@ -472,6 +672,14 @@ namespace SleepyDiscord {
 			setError(RATE_LIMITED);
 			return false;
 		}
+		if (gatewayEncoding == GatewayEncoding::ETF) {
+			//payloads are made as JSON, so convert them
+			std::string payload;
+			if (!ETF::encodeJSON(message, payload))
+				return false;
+			sendBinary(std::move(payload), connection);
+			return true;
+		}
 		send(message, connection);
 		return true;
 	}
@@ -480,28 +688,181 @@ namespace SleepyDiscord {
 		return !key[i] ? 0 : (hash(key, i + 1) * 31) + key[i] - 'A';
 	}
 
+	namespace {
+#ifdef SLEEPY_SAX_FROM_JSON
+		inline uint64_t getEventKey(const Ready&) {
+			return 0;
+		}
+
+		template<class Type>
+		inline uint64_t getEventKey(const Snowflake<Type>& serverID) {
+			const auto ID = serverID.string();
+			return KeyedDispatcher<BaseDiscordClient>::getKey(ID.data(), ID.length());
+		}
+
+		inline uint64_t getEventKey(const Server& server) {
+			return getEventKey(server.ID);
+		}
+
+		inline uint64_t getEventKey(const ServerMembersChunk& chunk) {
+			return getEventKey(chunk.serverID);
+		}
+
+		//puts the object in the frame and null in the document
+		template<class Object>
+		struct EventReceiver {
+			Frame* frame;
+			inline void receive(Object&& object) {
+				const uint64_t key = getEventKey(object);
+				frame->event.reset(new ParsedEventOf<Object>(std::move(object)));
+				frame->event->dispatchKey = key;
+				frame->getDocument().Null();
+			}
+		};
+
+		//sends everything to the document, except d for the events that are read directly
+		//t needs to come before d for that, which it does in the messages from Discord
+		class GatewayNode : public json::SAX::Node {
+		public:
+			GatewayNode(Frame& _frame) : frame(_frame), document(_frame.getDocument()) {}
+
+			bool value(json::SAX::Parser& parser, json::Value& value) override {
+				if (depth == 1 && lastKey == Key::Type && value.IsString())
+					eventName.assign(value.GetString(), value.GetStringLength());
+				return json::SAX::forward(document, value, parser.isStringCopied());
+			}
+			bool key(json::SAX::Parser& parser, const char* name, SizeType length) override {
+				lastKey = depth != 1 || length != 1 ? Key::Other :
+					name[0] == 't' ? Key::Type :
+					name[0] == 'd' ? Key::Data : Key::Other;
+				return document.Key(name, length, parser.isStringCopied());
+			}
+			bool start(json::SAX::Parser& parser, bool isObject) override {
+				if (depth == 1 && lastKey == Key::Data && isObject) {
+					if (eventName == "GUILD_CREATE")
+						return startEvent<Server>(parser);
+					if (eventName == "GUILD_MEMBERS_CHUNK")
+						return startEvent<ServerMembersChunk>(parser);
+					if (eventName == "READY")
+						return startEvent<Ready>(parser);
+				}
+				++depth;
+				return isObject ? document.StartObject() : document.StartArray();
+			}
+			bool end(json::SAX::Parser&, bool isObject, SizeType count) override {
+				--depth;
+				return isObject ? document.EndObject(count) : document.EndArray(count);
+			}
+
+		private:
+			template<class Object>
+			inline bool startEvent(json::SAX::Parser& parser) {
+				parser.push(std::unique_ptr<json::SAX::Node>(
+					new json::SAX::ObjectNode<Object, EventReceiver<Object>>(EventReceiver<Object>{ &frame })));
+				return true;
+			}
+
+			enum class Key { Other, Type, Data };
+			Frame& frame;
+			Frame::Document& document;
+			std::size_t depth = 0;
+			Key lastKey = Key::Other;
+			std::string eventName;
+		};
+#endif
+
+		//parses the frame, and reads the data of some events straight into their objects
+		bool parseDirectly(Frame& frame) {
+#ifdef SLEEPY_SAX_FROM_JSON
+			bool isParsed = false;
+			auto generator = [&frame, &isParsed](Frame::Document&) {
+				json::SAX::Parser parser(std::unique_ptr<json::SAX::Node>(new GatewayNode(frame)));
+				isParsed = !json::parseTokensInsitu(parser, frame.text).IsError();
+				return isParsed;
+			};
+			frame.getDocument().Populate(generator);
+			return isParsed;
+#else
+			return !frame.parse().IsError();
+#endif
+		}
+
+		//the event's object, from the frame or the data
+		template<class Object>
+		inline Object takeEvent(ParsedEvent* event, json::Value& d) {
+			if (event == nullptr)
+				return Object(d);
+			return std::move(static_cast<ParsedEventOf<Object>*>(event)->object);
+		}
+
+		//lazy objects keep the frame, so that their json is there when they read it
+		struct SharedFrame {
+			FramePool& pool;
+			FramePool::Lease& frame;
+			std::shared_ptr<const void> shared;
+
+			const std::shared_ptr<const void>& get() {
+				if (!shared)
+					shared = pool.share(std::move(frame));
+				return shared;
+			}
+		};
+	}
+
 	void BaseDiscordClient::processMessage(const std::string &message) {
-		auto docPtr = std::make_shared<rapidjson::Document>();
-		rapidjson::Document& document = *docPtr;
-		document.Parse(message.c_str(), message.length());
+		FramePool::Lease frame = framePool.acquire();
+		frame->text.assign(message);
+		processFrame(std::move(frame));
+	}
+
+	void BaseDiscordClient::processFrame(FramePool::Lease frame) {
+		Frame::Document& document = frame->getDocument();
+		const bool isParsed = gatewayEncoding == GatewayEncoding::ETF ?
+			ETF::decode(frame->text.data(), frame->text.length(), document, document.GetAllocator()) :
+			directEventParsing ? parseDirectly(*frame) : !frame->parse().IsError();
+		if (!isParsed || !document.IsObject())
+			return;
 		//	{ "op", "d", "s", "t" }
 		int op = document["op"].GetInt();
 		json::Value& d = document["d"];
 		switch (op) {
-		case DISPATCH:
+		case DISPATCH: {
 			lastSReceived = document["s"].GetInt();
-			postTask(
-				[this, docPtr, &d]() {
-					rapidjson::Document& document = *docPtr;
-					const json::Value& t = document["t"];
-					handleDispatchEvent(t, d);
-				}
-			);
-		break;
+			//tasks need to be copyable, so the frame is passed as a pointer and taken back in the task
+			const json::Value& t = document["t"];
+			//HELLO and INVALID_SESSION use the session, so it's changed here instead of in the
+			//task, which runs on another thread. Only the user's callbacks wait for the barrier
+			const bool isReady = t.IsString() && t == "READY";
+			const bool isResumed = t.IsString() && t == "RESUMED";
+			if (isReady) {
+				Ready readyData = takeEvent<Ready>(frame->event.get(), d);
+				sessionID = readyData.sessionID;
+				bot = readyData.user.bot;
+				updateAuthHeaders();
+				userID = readyData.user;
+				//so that the task doesn't read it again
+				frame->event.reset(new ParsedEventOf<Ready>(std::move(readyData)));
+			}
+			if (isReady || isResumed) {
+				ready = true;
+				stopReconnecting(); //Successfully connected
+			}
+			Frame* dispatchFrame = frame.release();
+			auto task = [this, dispatchFrame]() {
+				FramePool::Lease frame = framePool.adopt(dispatchFrame);
+				handleDispatchEvent(frame);
+			};
+			//the session events change what every other event uses, so they don't run alongside them
+			if (isReady || isResumed)
+				eventDispatcher.postBarrier(std::move(task));
+			else
+				eventDispatcher.post(dispatchFrame->event ? dispatchFrame->event->dispatchKey : getDispatchKey(t, d), std::move(task));
+		} break;
 		case HELLO:
 			heartbeatInterval = d["heartbeat_interval"].GetInt();
 			heartbeat();
-			if (!ready) sendIdentity();
+			//a session from resumeSession can be resumed before this client was ever ready
+			if (!ready && sessionID.empty()) identify();
 			else sendResume();
 			break;
 		case RECONNECT:
@@ -512,7 +873,7 @@ namespace SleepyDiscord {
 				schedule(&BaseDiscordClient::sendResume, 2500);
 			} else {
 				sessionID = "";
-				schedule(&BaseDiscordClient::sendIdentity, 2500);
+				schedule(&BaseDiscordClient::identify, 2500);
 			}
 			break;
 		case HEARTBEAT_ACK:
@@ -522,41 +883,90 @@ namespace SleepyDiscord {
 		}
 	}
 
-	void BaseDiscordClient::handleDispatchEvent(const json::Value& t, json::Value& d) {
-		switch (hash(json::toStdString(t).c_str())) {
+	uint64_t BaseDiscordClient::getDispatchKey(const json::Value& t, const json::Value& d) {
+		if (!d.IsObject())
+			return 0;
+		const auto getKey = [&d](const char* name, uint64_t& key) {
+			const auto found = d.FindMember(name);
+			if (found == d.MemberEnd() || !found->value.IsString())
+				return false;
+			key = KeyedDispatcher<BaseDiscordClient>::getKey(found->value.GetString(), found->value.GetStringLength());
+			return true;
+		};
+		uint64_t key = 0;
+		if (getKey("guild_id", key))
+			return key;
+		//in the server events, the server's id is just id
+		static constexpr char serverEvent[] = "GUILD_";
+		constexpr std::size_t serverEventLength = sizeof(serverEvent) - 1;
+		if (t.IsString() && serverEventLength <= t.GetStringLength() &&
+			std::memcmp(t.GetString(), serverEvent, serverEventLength) == 0 && getKey("id", key))
+			return key;
+		if (getKey("channel_id", key))
+			return key;
+		return 0;
+	}
+
+	void BaseDiscordClient::handleDispatchEvent(FramePool::Lease& frame) {
+		Frame::Document& document = frame->getDocument();
+		const json::Value& t = document["t"];
+		json::Value& d = document["d"];
+		ParsedEvent* event = frame->event.get();
+		//once it's shared, this keeps the frame until the event is handled
+		SharedFrame sharedFrame{ framePool, frame, nullptr };
+		switch (hash(t.IsString() ? t.GetString() : "")) {
 		case hash("READY"): {
-			Ready readyData = d;
-			sessionID = readyData.sessionID;
-			bot = readyData.user.bot;
-			userID = readyData.user;
+			//the session was already changed in processFrame
+			Ready readyData = takeEvent<Ready>(event, d);
+			if (serverCache)
+				removeStaleServers(readyData.servers);
 			onReady(readyData);
-			ready = true;
-			stopReconnecting(); //Successfully connected
+			startCacheExpiry();
 		} break;
 		case hash("RESUMED"):
-			stopReconnecting(); //Successfully connected
 			onResumed();
 			break;
 		case hash("GUILD_CREATE"): {
-			Server server(d);
-			if (serverCache)
-				serverCache->insert(server);
+			//the cache needs the whole server anyway
+			if (event || serverCache) {
+				Server server = takeEvent<Server>(event, d);
+				if (serverCache)
+					serverCache->insert(server);
+				if (permissionCache)
+					permissionCache->eraseServer(server.ID);
+				onServer(LazyServer(std::move(server)));
+				break;
+			}
+			const LazyServer server(sharedFrame.get(), d);
+			if (permissionCache)
+				permissionCache->eraseServer(server.get(&Server::ID));
 			onServer(server);
 		} break;
 		case hash("GUILD_DELETE"): {
 			UnavailableServer server(d);
-			if (serverCache) {
-				findServerInCache(server.ID, [=](ServerCache::iterator& found) {
-					serverCache->erase(found);
-					});
-			}
+			if (serverCache)
+				serverCache->erase(server.ID);
+			//unavailable servers are only having an outage, so their messages are still there
+			if (messageCache && server.unavailable != UnavailableServer::AvailableFlag::Unavaiable)
+				messageCache->eraseServer(server.ID);
+			if (permissionCache)
+				permissionCache->eraseServer(server.ID);
 			onDeleteServer(server);
 		} break;
 		case hash("GUILD_UPDATE"): {
 			Server server(d);
-			accessServerFromCache(server.ID, [server](Server& foundServer) {
+			accessServerFromCache(server.ID, [this, server](Server& foundServer) {
+				//updates replace the roles but don't have members or channels
+				const ServerCache::Key& serverID = foundServer.ID.raw();
+				for (const Role& role : foundServer.roles)
+					serverCache->removeFromIndex(serverID, role.ID);
 				json::mergeObj(foundServer, server);
+				for (const Role& role : foundServer.roles)
+					serverCache->addToIndex(serverID, role);
 				});
+			//the owner or roles could have changed
+			if (permissionCache)
+				permissionCache->invalidateServer(server.ID);
 			onEditServer(server);
 		} break;
 		case hash("GUILD_BAN_ADD"): onBan(d["guild_id"], d["user"]); break;
@@ -565,13 +975,15 @@ namespace SleepyDiscord {
 		case hash("GUILD_MEMBER_ADD"): {
 			Snowflake<Server> serverID = d["guild_id"];
 			ServerMember member(d);
-			appendObjectToCache(serverID, &Server::members, member);
+			appendObjectToCache(serverID, member);
 			onMember(serverID, member);
 		} break;
 		case hash("GUILD_MEMBER_REMOVE"): {
 			Snowflake<Server> serverID = d["guild_id"];
 			User user = d["user"];
-			eraseObjectFromCache(serverID, &Server::members, user.ID);
+			eraseObjectFromCache(serverID, user.ID);
+			if (permissionCache)
+				permissionCache->invalidateMember(serverID, user.ID);
 			onRemoveMember(serverID, user);
 		} break;
 		case hash("GUILD_MEMBER_UPDATE"): {
@@ -588,13 +1000,15 @@ namespace SleepyDiscord {
 					member.nick = nick;
 				}
 			);
+			if (permissionCache)
+				permissionCache->invalidateMember(serverID, user.ID);
 			onEditMember(serverID, user, roles, nick);
 		} break;
-		case hash("GUILD_MEMBERS_CHUNK"): onMemberChunk(d); break;
+		case hash("GUILD_MEMBERS_CHUNK"): onMemberChunk(takeEvent<ServerMembersChunk>(event, d)); break;
 		case hash("GUILD_ROLE_CREATE"): {
 			Snowflake<Server> serverID = d["guild_id"];
 			Role role = d["role"];
-			appendObjectToCache(serverID, &Server::roles, role);
+			appendObjectToCache(serverID, role);
 			onRole(serverID, role);
 		} break;
 		case hash("GUILD_ROLE_UPDATE"):
@@ -606,18 +1020,22 @@ namespace SleepyDiscord {
 					foundRole = role;
 				}
 			);
+			if (permissionCache)
+				permissionCache->invalidateServer(serverID);
 			onEditRole(serverID, role);
 		} break;
 		case hash("GUILD_ROLE_DELETE"): {
 			Snowflake<Server> serverID = d["guild_id"];
 			Snowflake<Role> roleID = d["role_id"];
-			eraseObjectFromCache(serverID, &Server::roles, roleID);
+			eraseObjectFromCache(serverID, roleID);
+			if (permissionCache)
+				permissionCache->invalidateServer(serverID);
 			onDeleteRole(serverID, roleID);
 		} break;
 		case hash("GUILD_EMOJIS_UPDATE"): onEditEmojis(d["guild_id"], json::toArray<Emoji>(d["emojis"])); break;
 		case hash("CHANNEL_CREATE"): {
 			Channel channel = d;
-			appendObjectToCache(channel.serverID, &Server::channels, channel);
+			appendObjectToCache(channel.serverID, channel);
 			onChannel(d);
 		} break;
 		case hash("CHANNEL_UPDATE"): {
@@ -627,11 +1045,17 @@ namespace SleepyDiscord {
 					foundChannel = channel;
 				}
 			);
+			if (permissionCache)
+				permissionCache->invalidateChannel(channel.ID);
 			onEditChannel(d);
 		} break;
 		case hash("CHANNEL_DELETE"): {
 			Channel channel = d;
-			eraseObjectFromCache(channel.serverID, &Server::channels, channel.ID);
+			eraseObjectFromCache(channel.serverID, channel.ID);
+			if (messageCache)
+				messageCache->eraseChannel(channel.ID);
+			if (permissionCache)
+				permissionCache->invalidateChannel(channel.ID);
 			onDeleteChannel(d);
 		} break;
 		case hash("CHANNEL_PINS_UPDATE"): {
@@ -642,13 +1066,14 @@ namespace SleepyDiscord {
 				json::toStdString(d["last_pin_timestamp"]) : ""
 			);
 		} break;
-		case hash("PRESENCE_UPDATE"): onPresenceUpdate(d); break;
+		case hash("PRESENCE_UPDATE"): onPresenceUpdate(LazyPresenceUpdate(sharedFrame.get(), d)); break;
 		case hash("PRESENCES_REPLACE"):                          break;
 		case hash("USER_UPDATE"): onEditUser(d); break;
 		case hash("USER_SETTINGS_UPDATE"): onEditUserSettings(d); break;
 		case hash("VOICE_STATE_UPDATE"): {
 			VoiceState state(d);
 #ifdef SLEEPY_VOICE_ENABLED
+			std::unique_lock<std::mutex> voiceLock(voiceMutex);
 			if (!waitingVoiceContexts.empty()) {
 				auto iterator = find_if(waitingVoiceContexts.begin(), waitingVoiceContexts.end(),
 					[&state](const VoiceContext* w) {
@@ -660,17 +1085,63 @@ namespace SleepyDiscord {
 					connectToVoiceIfReady(context);
 				}
 			}
+			voiceLock.unlock();
 #endif
 			onEditVoiceState(state);
 		} break;
 		case hash("TYPING_START"): onTyping(d["channel_id"], d["user_id"], d["timestamp"].GetInt64() * 1000); break;
-		case hash("MESSAGE_CREATE"): onMessage(d); break;
-		case hash("MESSAGE_UPDATE"): onEditMessage(d); break;
-		case hash("MESSAGE_DELETE"): onDeleteMessages(d["channel_id"], { d["id"] }); break;
-		case hash("MESSAGE_DELETE_BULK"): onDeleteMessages(d["channel_id"], json::toArray<Snowflake<Message>>(d["ids"])); break;
+		case hash("MESSAGE_CREATE"): {
+			//members that talk are the ones worth keeping in an LRU cache
+			if (serverCache && serverCache->getPolicies().members.isTracked()) {
+				auto serverValue = d.FindMember("guild_id");
+				auto authorValue = d.FindMember("author");
+				if (serverValue != d.MemberEnd() && authorValue != d.MemberEnd() && authorValue->value.IsObject()) {
+					Snowflake<Server> serverID = serverValue->value;
+					auto authorID = authorValue->value.FindMember("id");
+					if (authorID != authorValue->value.MemberEnd()) {
+						Snowflake<User> userID = authorID->value;
+						accessServerFromCache(serverID, [this, userID](Server& server) {
+							serverCache->useObject(server, userID);
+						});
+					}
+				}
+			}
+			if (!messageCache) {
+				onMessage(LazyMessage(sharedFrame.get(), d));
+				break;
+			}
+			Message message(d);
+			messageCache->add(message);
+			onMessage(LazyMessage(std::move(message)));
+		} break;
+		case hash("MESSAGE_UPDATE"): {
+			MessageRevisions revisions(d);
+			Message before;
+			Message after;
+			if (messageCache && messageCache->update(revisions, &before, &after))
+				onEditCachedMessage(before, after);
+			onEditMessage(revisions);
+		} break;
+		case hash("MESSAGE_DELETE"):
+		case hash("MESSAGE_DELETE_BULK"): {
+			const Snowflake<Channel> channelID = d["channel_id"];
+			//bulk deletes have ids instead of id
+			auto idsValue = d.FindMember("ids");
+			std::vector<Snowflake<Message>> messageIDs = idsValue != d.MemberEnd() ?
+				json::toArray<Snowflake<Message>>(idsValue->value) : std::vector<Snowflake<Message>>{ d["id"] };
+			if (messageCache) {
+				for (const Snowflake<Message>& messageID : messageIDs) {
+					tl::optional<Message> message = messageCache->erase(channelID, messageID);
+					if (message)
+						onDeleteCachedMessage(std::move(*message));
+				}
+			}
+			onDeleteMessages(channelID, std::move(messageIDs));
+		} break;
 		case hash("VOICE_SERVER_UPDATE"): {
 			VoiceServerUpdate voiceServer(d);
 #ifdef SLEEPY_VOICE_ENABLED
+			std::unique_lock<std::mutex> voiceLock(voiceMutex);
 			if (!waitingVoiceContexts.empty()) {
 				auto iterator = find_if(waitingVoiceContexts.begin(), waitingVoiceContexts.end(),
 					[&voiceServer](const VoiceContext* w) {
@@ -683,6 +1154,7 @@ namespace SleepyDiscord {
 					connectToVoiceIfReady(context);
 				}
 			}
+			voiceLock.unlock();
 #endif
 			onEditVoiceServer(voiceServer);
 		} break;
@@ -706,28 +1178,31 @@ namespace SleepyDiscord {
 	void BaseDiscordClient::processMessage(const WebSocketMessage message) {
 		switch (message.opCode) {
 		case WebSocketMessage::OPCode::binary: {
-			if (!compressionHandler)
+			if (!compressionHandler) {
+				//ETF is sent in binary messages
+				if (gatewayEncoding == GatewayEncoding::ETF)
+					processMessage(message.payload);
 				break;
+			}
 			compressionHandler->uncompress(message.payload);
-			
-			//when using transport connections, Discord ends streams the flush siginal
-			constexpr std::array<const char, 4> flushSiginal = { 0, 0, '\xFF', '\xFF'};
-			constexpr std::size_t siginalLength = flushSiginal.max_size();
-			bool endsWithFlushSiginal = false;
-			if (useTrasportConnection == 1 && siginalLength <= message.payload.length()) {
-				const auto compare = message.payload.compare(
-					message.payload.length() - siginalLength, siginalLength,
-					flushSiginal.data(), siginalLength);
-				endsWithFlushSiginal = compare == 0;
+			if (compressionHandler->hasFailed()) {
+				onError(GENERAL_ERROR, "Failed to uncompress a message from the gateway");
+				//the stream can't go on after an error, reconnecting starts a new one
+				reconnect();
+				break;
 			}
 
+			//when using transport connections, the compression knows where messages end
+			const bool isEndOfMessage = useTrasportConnection == 1 &&
+				compressionHandler->isEndOfMessage(message.payload);
+
 			//trasportConnection doesn't stop the stream
 			bool streamEnded = useTrasportConnection != 1 && compressionHandler->streamEnded();
 
-			if (streamEnded || endsWithFlushSiginal) {
-				std::shared_ptr<std::string> uncompressed = std::make_shared<std::string>();
-				compressionHandler->getOutput(*uncompressed);
-				processMessage(*uncompressed);
+			if (streamEnded || isEndOfMessage) {
+				FramePool::Lease frame = framePool.acquire();
+				compressionHandler->getOutput(frame->text);
+				processFrame(std::move(frame));
 			}
 			break;
 		}
@@ -811,6 +1286,7 @@ namespace SleepyDiscord {
 
 	VoiceContext& BaseDiscordClient::createVoiceContext(Snowflake<Server> server, Snowflake<Channel> channel, BaseVoiceEventHandler * eventHandler) {
 		Snowflake<Server> serverTarget = server != "" ? server : getChannel(channel).cast().serverID;
+		std::lock_guard<std::mutex> lock(voiceMutex);
 		voiceContexts.push_front({ serverTarget, channel, eventHandler });
 		waitingVoiceContexts.emplace_front(&voiceContexts.front());
 		return voiceContexts.front();
@@ -872,6 +1348,7 @@ namespace SleepyDiscord {
 	}
 
 	void BaseDiscordClient::removeVoiceConnectionAndContext(VoiceConnection & connection) {
+		std::lock_guard<std::mutex> lock(voiceMutex);
 		const VoiceContext& context = connection.getContext();
 		voiceConnections.remove_if(
 			[&connection](VoiceConnection& right) {
@@ -903,53 +1380,59 @@ namespace SleepyDiscord {
 		return json::createJSONArray(params);
 	}
 
-	Route::Route(const std::string route, const std::initializer_list<std::string>& _values)
-		: path(route), values(_values)
+	Route::Route(const RouteTemplate& route, const std::initializer_list<std::string>& values) :
+		routeTemplate(route)
 	{
-		size_t targetSize = path.length();
-		for (std::string replacement : values)
-			targetSize += replacement.length();
-		_url.reserve(targetSize);
-
-		//In the future, use string view
+		build(values);
+	}
 
-		size_t offset = 0;
-		for (std::string replacement : values) {
-			const size_t start = path.find('{', offset);
-			const size_t end = path.find('}', start);
+	Route::Route(const std::string route, const std::initializer_list<std::string>& values) :
+		ownedPath(std::make_shared<const std::string>(route)),
+		routeTemplate(ownedPath->c_str(), ownedPath->length())
+	{
+		build(values);
+	}
 
-			//the +1 and -1 removes the { and }
-			const std::string identifier = path.substr(start + 1, end - start - 1);
+	Route::Route(const char* route) : Route(std::string(route)) {}
 
-			auto foundParam = majorParameters.find(identifier);
-			if (foundParam != majorParameters.end()) {
-				foundParam->second = replacement;
-			}
+	void Route::build(const std::initializer_list<std::string>& values) {
+		const char* const path = routeTemplate.path;
+		const std::size_t pathLength = routeTemplate.length;
 
-			_url += path.substr(offset, start - offset);
-			_url += replacement;
-			offset = end + 1; //the +1 removes the }
-		}
-		_url += path.substr(offset, path.length() - offset);
+		std::size_t targetSize = pathLength;
+		for (const std::string& replacement : values)
+			targetSize += replacement.length();
+		_url.reserve(targetSize);
 
-	}
+		std::size_t offset = 0;
+		int index = 0;
+		for (const std::string& replacement : values) {
+			const char* start = static_cast<const char*>(std::memchr(path + offset, '{', pathLength - offset));
+			if (start == nullptr)
+				break;
+			const char* end = static_cast<const char*>(std::memchr(start, '}', path + pathLength - start));
+			if (end == nullptr)
+				break;
 
-	Route::Route(const char* route) : Route(route, {}) {}
+			if (index == routeTemplate.majorParameter) {
+				//major parameters are snowflakes, if it isn't one, use a hash of it
+				uint64_t id = 0;
+				bool isNumber = !replacement.empty();
+				for (const char digit : replacement) {
+					if (digit < '0' || '9' < digit) {
+						isNumber = false;
+						break;
+					}
+					id = id * 10 + static_cast<uint64_t>(digit - '0');
+				}
+				majorID = isNumber ? id : RouteTemplate::hashPath(replacement.c_str());
+			}
 
-	const std::string Route::bucket(RequestMethod method) {
-		std::string target;
-		std::string methodString = std::to_string(method);
-		size_t targetLength = methodString.length();
-		for (auto param : majorParameters) {
-			targetLength += param.second.length();
-		}
-		targetLength = path.length();
-		target.reserve(targetLength);
-		target += methodString;
-		for (auto param : majorParameters) {
-			target += param.second;
+			_url.append(path + offset, start - (path + offset));
+			_url += replacement;
+			offset = end - path + 1; //the +1 removes the }
+			++index;
 		}
-		target += path;
-		return target;
+		_url.append(path + offset, pathLength - offset);
 	}
 }
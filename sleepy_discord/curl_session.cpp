@@ -0,0 +1,284 @@
+#include "curl_session.h"
+#ifndef NONEXISTENT_CURL
+#include <cstring>
+
+namespace SleepyDiscord {
+	CurlSession::CurlSession() : handle(curl_easy_init()) {
+		curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+		curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+		curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &CurlSession::writeCallback);
+		curl_easy_setopt(handle, CURLOPT_WRITEDATA, this);
+		curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, &CurlSession::headerCallback);
+		curl_easy_setopt(handle, CURLOPT_HEADERDATA, this);
+	}
+
+	CurlSession::~CurlSession() {
+		curl_easy_cleanup(handle);
+		if (headerList != nullptr)
+			curl_slist_free_all(headerList);
+		if (mime != nullptr)
+			curl_mime_free(mime);
+	}
+
+	void CurlSession::setBody(const std::string* jsonParameters) {
+		body = jsonParameters;
+		if (mime != nullptr) {
+			curl_easy_setopt(handle, CURLOPT_MIMEPOST, nullptr);
+			curl_mime_free(mime);
+			mime = nullptr;
+		}
+	}
+
+	void CurlSession::setHeader(const std::vector<HeaderPair>& header) {
+		curl_slist* list = nullptr;
+		std::string line;
+		for (const HeaderPair& pair : header) {
+			line.clear();
+			line += pair.name;
+			line += ": ";
+			line += pair.value;
+			list = curl_slist_append(list, line.c_str());
+		}
+		curl_easy_setopt(handle, CURLOPT_HTTPHEADER, list);
+		if (headerList != nullptr)
+			curl_slist_free_all(headerList);
+		headerList = list;
+	}
+
+	void CurlSession::setMultipart(const std::vector<Part>& parts) {
+		body = nullptr;
+		if (mime != nullptr)
+			curl_mime_free(mime);
+		mime = curl_mime_init(handle);
+		for (const Part& part : parts) {
+			curl_mimepart* field = curl_mime_addpart(mime);
+			curl_mime_name(field, part.name.c_str());
+			if (part.isFile) curl_mime_filedata(field, part.value.c_str());
+			else             curl_mime_data(field, part.value.c_str(), part.value.length());
+		}
+	}
+
+	void CurlSession::prepare(RequestMethod method) {
+		response = Response();
+		if (method == Get) {
+			curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, nullptr);
+			curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
+			return;
+		}
+
+		if (mime != nullptr) {
+			curl_easy_setopt(handle, CURLOPT_MIMEPOST, mime);
+		} else {
+			curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, static_cast<long>(body ? body->length() : 0));
+			curl_easy_setopt(handle, CURLOPT_POSTFIELDS, body ? body->c_str() : "");
+		}
+		//setting the body makes curl use post, so change it to the method we want
+		curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, method == Post ? nullptr : getMethodName(method));
+	}
+
+	Response CurlSession::request(RequestMethod method) {
+		prepare(method);
+#ifdef SLEEPY_CURL_MULTI
+		if (multi != nullptr && responseCallback) {
+			multi->add(*this);
+			return Response();
+		}
+#endif
+		return finish(curl_easy_perform(handle));
+	}
+
+	Response CurlSession::finish(CURLcode result) {
+		Response target = std::move(response);
+		response = Response();
+		if (result == CURLE_OK) {
+			long statusCode = 0;
+			curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &statusCode);
+			target.statusCode = static_cast<int32_t>(statusCode);
+		} else {
+			target.statusCode = 0;
+			target.text = curl_easy_strerror(result);
+		}
+
+		if (!responseCallback)
+			return target;
+		//the callback might give back or destroy this session, so don't use any members after calling it
+		ResponseCallback callback = std::move(responseCallback);
+		responseCallback = nullptr;
+		callback(std::move(target));
+		return Response();
+	}
+
+	void CurlSession::cancel() {
+		ResponseCallback callback = std::move(responseCallback);
+		responseCallback = nullptr;
+	}
+
+	std::size_t CurlSession::writeCallback(char* data, std::size_t size, std::size_t count, void* sessionPtr) {
+		const std::size_t length = size * count;
+		static_cast<CurlSession*>(sessionPtr)->response.text.append(data, length);
+		return length;
+	}
+
+	std::size_t CurlSession::headerCallback(char* data, std::size_t size, std::size_t count, void* sessionPtr) {
+		const std::size_t length = size * count;
+		Response& target = static_cast<CurlSession*>(sessionPtr)->response;
+		std::size_t end = length;
+		while (0 < end && (data[end - 1] == '\r' || data[end - 1] == '\n'))
+			--end;
+		//a new status line means that the headers before it were for a redirect
+		static constexpr char statusStart[] = "HTTP/";
+		if (sizeof(statusStart) - 1 <= end && std::memcmp(data, statusStart, sizeof(statusStart) - 1) == 0) {
+			target.header.clear();
+			return length;
+		}
+		const char* name = data;
+		const char* colon = static_cast<const char*>(std::memchr(name, ':', end));
+		if (colon == nullptr)
+			return length;
+		const char* value = colon + 1;
+		const char* valueEnd = name + end;
+		while (value < valueEnd && (*value == ' ' || *value == '\t'))
+			++value;
+		target.header[std::string(name, colon)] = std::string(value, valueEnd);
+		return length;
+	}
+
+#ifdef SLEEPY_CURL_MULTI
+	struct CurlMulti::Socket {
+		Socket(asio::io_service& io, curl_socket_t _native) :
+			descriptor(io, _native), native(_native) {}
+		~Socket() {
+			//curl closes the socket, so only stop watching it
+			asio::error_code error;
+			descriptor.cancel(error);
+			descriptor.release();
+		}
+		asio::posix::stream_descriptor descriptor;
+		const curl_socket_t native;
+		int what = 0; //what curl wants to wait for
+		bool isReading = false;
+		bool isWriting = false;
+	};
+
+	CurlMulti::CurlMulti(asio::io_service& service) :
+		io(service), strand(service), handle(curl_multi_init()), timer(service)
+	{
+		curl_multi_setopt(handle, CURLMOPT_SOCKETFUNCTION, &CurlMulti::socketCallback);
+		curl_multi_setopt(handle, CURLMOPT_SOCKETDATA, this);
+		curl_multi_setopt(handle, CURLMOPT_TIMERFUNCTION, &CurlMulti::timerCallback);
+		curl_multi_setopt(handle, CURLMOPT_TIMERDATA, this);
+	}
+
+	CurlMulti::~CurlMulti() {
+		timer.cancel();
+		std::unordered_map<CURL*, CurlSession*> unfinished;
+		unfinished.swap(transfers);
+		for (auto& transfer : unfinished) {
+			curl_multi_remove_handle(handle, transfer.first);
+			//calling the callback here could call into an object that is being destroyed
+			transfer.second->cancel();
+		}
+		sockets.clear();
+		curl_multi_cleanup(handle);
+	}
+
+	void CurlMulti::add(CurlSession& session) {
+		//curl's multi isn't thread safe, so only use it in the strand
+		asio::post(strand, [this, &session]() {
+			CURL* easy = session.handle;
+			transfers[easy] = &session;
+			if (curl_multi_add_handle(handle, easy) != CURLM_OK) {
+				transfers.erase(easy);
+				session.finish(CURLE_FAILED_INIT);
+			}
+		});
+	}
+
+	int CurlMulti::socketCallback(CURL*, curl_socket_t socket, int what, void* multiPtr, void*) {
+		CurlMulti& multi = *static_cast<CurlMulti*>(multiPtr);
+		if (what == CURL_POLL_REMOVE) {
+			multi.sockets.erase(socket);
+			return 0;
+		}
+
+		std::shared_ptr<Socket>& watched = multi.sockets[socket];
+		if (!watched)
+			watched = std::make_shared<Socket>(multi.io, socket);
+		watched->what = what;
+		multi.watch(watched, CURL_POLL_IN);
+		multi.watch(watched, CURL_POLL_OUT);
+		return 0;
+	}
+
+	int CurlMulti::timerCallback(CURLM*, long timeout, void* multiPtr) {
+		CurlMulti& multi = *static_cast<CurlMulti*>(multiPtr);
+		multi.timer.cancel();
+		if (timeout < 0)
+			return 0;
+		//curl doesn't allow calling socket action from here, so always wait on the timer
+		multi.timer.expires_after(std::chrono::milliseconds(timeout));
+		multi.timer.async_wait(asio::bind_executor(multi.strand, [&multi](const asio::error_code& error) {
+			if (error == asio::error::operation_aborted)
+				return;
+			multi.onEvent(CURL_SOCKET_TIMEOUT, 0);
+		}));
+		return 0;
+	}
+
+	void CurlMulti::watch(const std::shared_ptr<Socket>& socket, const int direction) {
+		const bool isRead = direction == CURL_POLL_IN;
+		bool& isWaiting = isRead ? socket->isReading : socket->isWriting;
+		if (isWaiting || !(socket->what & direction))
+			return;
+		isWaiting = true;
+
+		std::weak_ptr<Socket> weakSocket = socket;
+		socket->descriptor.async_wait(
+			isRead ? asio::posix::stream_descriptor::wait_read : asio::posix::stream_descriptor::wait_write,
+			asio::bind_executor(strand, [this, weakSocket, direction, isRead](const asio::error_code& error) {
+				//the socket is gone when curl removed it or the multi was destroyed
+				std::shared_ptr<Socket> socket = weakSocket.lock();
+				if (!socket)
+					return;
+				(isRead ? socket->isReading : socket->isWriting) = false;
+				if (error == asio::error::operation_aborted)
+					return;
+
+				onEvent(socket->native,
+					error ? CURL_CSELECT_ERR : isRead ? CURL_CSELECT_IN : CURL_CSELECT_OUT);
+
+				auto found = sockets.find(socket->native);
+				if (found != sockets.end() && found->second == socket)
+					watch(socket, direction);
+			})
+		);
+	}
+
+	void CurlMulti::onEvent(curl_socket_t socket, int eventBitmask) {
+		int running = 0;
+		curl_multi_socket_action(handle, socket, eventBitmask, &running);
+		checkFinished();
+	}
+
+	void CurlMulti::checkFinished() {
+		int remaining = 0;
+		while (CURLMsg* message = curl_multi_info_read(handle, &remaining)) {
+			if (message->msg != CURLMSG_DONE)
+				continue;
+			//message can't be used after removing the handle
+			CURL* easy = message->easy_handle;
+			const CURLcode result = message->data.result;
+			curl_multi_remove_handle(handle, easy);
+
+			auto transfer = transfers.find(easy);
+			if (transfer == transfers.end())
+				continue;
+			CurlSession& session = *transfer->second;
+			transfers.erase(transfer);
+			session.finish(result);
+		}
+	}
+#endif
+}
+
+#endif
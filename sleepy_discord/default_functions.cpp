@@ -79,6 +79,10 @@ namespace SleepyDiscord {
 
 	}
 
+	void BaseDiscordClient::onPresenceUpdate(const LazyPresenceUpdate& presenceUpdate) {
+		onPresenceUpdate(presenceUpdate.toObject());
+	}
+
 	void BaseDiscordClient::onEditUser(User user) {
 
 	}
@@ -124,6 +128,10 @@ namespace SleepyDiscord {
 		
 	}
 
+	void BaseDiscordClient::onMessage(const LazyMessage& message) {
+		onMessage(message.toObject());
+	}
+
 	void BaseDiscordClient::onHeartbeat() {
 
 	}
@@ -136,6 +144,10 @@ namespace SleepyDiscord {
 	
 	}
 
+	void BaseDiscordClient::onServer(const LazyServer& server) {
+		onServer(server.toObject());
+	}
+
 	void BaseDiscordClient::onChannel(Channel channel) {
 
 	}
@@ -18,7 +18,7 @@ namespace SleepyDiscord {
 	//
 
 	//ObjectResponse<Message> BaseDiscordClient::sendMessage(Snowflake<Channel> channelID, CreateMessageParams& params) {
-	//	return ObjectResponse<Message>{ request(Post, path("channels/{channel.id}/messages", { channelID }), json::stringifyObj(params)) };
+	//	return ObjectResponse<Message>{ request(Post, path(Routes::channelMessages, { channelID }), json::stringifyObj(params)) };
 	//}
 
 	std::string createMessageBody(std::string& message, Embed& embed, MessageReference& replyingTo, TTS tts) {
@@ -35,20 +35,20 @@ namespace SleepyDiscord {
 	}
 
 	ObjectResponse<Gateway> BaseDiscordClient::getGateway(RequestSettings<ObjectResponse<Gateway>> settings) {
-		return ObjectResponse<Gateway>{ request(Get, "gateway/bot", settings) };
+		return ObjectResponse<Gateway>{ request(Get, Routes::gatewayBot, settings) };
 	}
 
 	ObjectResponse<Message> BaseDiscordClient::sendMessage(Snowflake<Channel> channelID, std::string message, Embed embed, MessageReference replyingTo, TTS tts, RequestSettings<ObjectResponse<Message>> settings) {
-		return ObjectResponse<Message>{ request(Post, path("channels/{channel.id}/messages", { channelID }), settings, createMessageBody(message, embed, replyingTo, tts)) };
+		return ObjectResponse<Message>{ request(Post, path(Routes::channelMessages, { channelID }), settings, createMessageBody(message, embed, replyingTo, tts)) };
 	}
 
 	ObjectResponse<Message> BaseDiscordClient::sendMessage(SendMessageParams params, RequestSettings<ObjectResponse<Message>> settings) {
-		return ObjectResponse<Message>{ request(Post, path("channels/{channel.id}/messages", { params.channelID }), settings, json::stringifyObj(params)) };
+		return ObjectResponse<Message>{ request(Post, path(Routes::channelMessages, { params.channelID }), settings, json::stringifyObj(params)) };
 	}
 
 	ObjectResponse<Message> BaseDiscordClient::uploadFile(Snowflake<Channel> channelID, std::string fileLocation, std::string message, Embed embed, MessageReference replyingTo, RequestSettings<ObjectResponse<Message>> settings) {
 		return ObjectResponse<Message>{
-			request(Post, path("channels/{channel.id}/messages", { channelID }), settings, "", {
+			request(Post, path(Routes::channelMessages, { channelID }), settings, "", {
 				{ "file", filePathPart{fileLocation} },
 				{ "payload_json", createMessageBody(message, embed, replyingTo, TTS::DisableTTS) }
 			})
@@ -57,7 +57,7 @@ namespace SleepyDiscord {
 
 	ObjectResponse<Message> BaseDiscordClient::uploadFile(SendMessageParams params, std::string fileLocation, RequestSettings<ObjectResponse<Message>> settings) {
 		return ObjectResponse<Message>{
-			request(Post, path("channels/{channel.id}/messages", { params.channelID }), settings, "", {
+			request(Post, path(Routes::channelMessages, { params.channelID }), settings, "", {
 				{ "file", filePathPart{fileLocation} },
 				{ "payload_json", json::stringifyObj(params) }
 			})
@@ -66,15 +66,15 @@ namespace SleepyDiscord {
 
 	ObjectResponse<Message> BaseDiscordClient::editMessage(Snowflake<Channel> channelID, Snowflake<Message> messageID, std::string newMessage, Embed embed, RequestSettings<ObjectResponse<Message>> settings) {
 		MessageReference mr{};
-		return ObjectResponse<Message>{ request(Patch, path("channels/{channel.id}/messages/{message.id}", { channelID, messageID }), settings, createMessageBody(newMessage, embed, mr, TTS::DisableTTS)) };
+		return ObjectResponse<Message>{ request(Patch, path(Routes::channelMessage, { channelID, messageID }), settings, createMessageBody(newMessage, embed, mr, TTS::DisableTTS)) };
 	}
 
 	ObjectResponse<Message> BaseDiscordClient::editMessage(EditMessageParams params, RequestSettings<ObjectResponse<Message>> settings) {
-		return ObjectResponse<Message>{ request(Patch, path("channels/{channel.id}/messages/{message.id}", { params.channelID, params.messageID }), settings, json::stringifyObj(params)) };
+		return ObjectResponse<Message>{ request(Patch, path(Routes::channelMessage, { params.channelID, params.messageID }), settings, json::stringifyObj(params)) };
 	}
 
 	BoolResponse BaseDiscordClient::deleteMessage(Snowflake<Channel> channelID, Snowflake<Message> messageID, RequestSettings<BoolResponse> settings) {
-		return { request(Delete, path("channels/{channel.id}/messages/{message.id}", { channelID, messageID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::channelMessage, { channelID, messageID }), settings), EmptyRespFn() };
 	}
 
 	BoolResponse BaseDiscordClient::bulkDeleteMessages(Snowflake<Channel> channelID, std::vector<Snowflake<Message>> messageIDs, RequestSettings<BoolResponse> settings) {
@@ -86,7 +86,7 @@ namespace SleepyDiscord {
 		if (messageIDs.size())
 			JSON.pop_back();
 		JSON += "]}";
-		return { request(Post, path("channels/{channel.id}/messages/bulk-delete", { channelID }), settings, JSON), EmptyRespFn() };
+		return { request(Post, path(Routes::channelMessagesBulkDelete, { channelID }), settings, JSON), EmptyRespFn() };
 	}
 
 	ObjectResponse<Channel> BaseDiscordClient::editChannel(Snowflake<Channel> channelID, std::string name, std::string topic, RequestSettings<ObjectResponse<Channel>> settings) {
@@ -103,7 +103,7 @@ namespace SleepyDiscord {
 			topicValue.SetString(topic.c_str(), topic.length());
 			doc.AddMember("topic", topicValue, allocator);
 		}
-		return ObjectResponse<Channel>{ request(Patch, path("channels/{channel.id}", { channelID }), settings, json::stringify(doc)) };
+		return ObjectResponse<Channel>{ request(Patch, path(Routes::channel, { channelID }), settings, json::stringify(doc)) };
 	}
 
 	ObjectResponse<Channel> BaseDiscordClient::editChannelName(Snowflake<Channel> channelID, std::string name, RequestSettings<ObjectResponse<Channel>> settings) {
@@ -115,11 +115,11 @@ namespace SleepyDiscord {
 	}
 
 	ObjectResponse<Channel> BaseDiscordClient::deleteChannel(Snowflake<Channel> channelID, RequestSettings<ObjectResponse<Channel>> settings) {
-		return ObjectResponse<Channel>{ request(Delete, path("channels/{channel.id}", { channelID }), settings) };
+		return ObjectResponse<Channel>{ request(Delete, path(Routes::channel, { channelID }), settings) };
 	}
 
 	ObjectResponse<Channel> BaseDiscordClient::getChannel(Snowflake<Channel> channelID, RequestSettings<ObjectResponse<Channel>> settings) {
-		return ObjectResponse<Channel>{ request(Get, path("channels/{channel.id}", { channelID }), settings) };
+		return ObjectResponse<Channel>{ request(Get, path(Routes::channel, { channelID }), settings) };
 	}
 
 	ArrayResponse<Message> BaseDiscordClient::getMessages(Snowflake<Channel> channelID, GetMessagesKey when, Snowflake<Message> messageID, uint8_t _limit, RequestSettings<ArrayResponse<Message>> settings) {
@@ -135,14 +135,14 @@ namespace SleepyDiscord {
 		if (trueLimit != 0 && when != GetMessagesKey::limit) key += '&';
 		return ArrayResponse<Message>{
 			request(Get,
-				path("channels/{channel.id}/messages{key}{limit}", { channelID, key,
+				path(Routes::channelMessagesQuery, { channelID, key,
 				(trueLimit != 0 ? "limit=" + std::to_string(trueLimit) : "") }), settings
 			)
 		};
 	}
 
 	ObjectResponse<Message> BaseDiscordClient::getMessage(Snowflake<Channel> channelID, Snowflake<Message> messageID, RequestSettings<ObjectResponse<Message>> settings) {
-		return ObjectResponse<Message>{ request(Get, path("channels/{channel.id}/messages/{message.id}", { channelID, messageID }), settings) };
+		return ObjectResponse<Message>{ request(Get, path(Routes::channelMessage, { channelID, messageID }), settings) };
 	}
 
 	std::string convertEmojiToURL(const std::string emoji) {
@@ -152,25 +152,25 @@ namespace SleepyDiscord {
 	}
 
 	BoolResponse BaseDiscordClient::addReaction(Snowflake<Channel> channelID, Snowflake<Message> messageID, std::string emoji, RequestSettings<BoolResponse> settings) {
-		return { request(Put, path("channels/{channel.id}/messages/{message.id}/reactions/{emoji}/@me", { channelID, messageID, convertEmojiToURL(emoji) }), settings), EmptyRespFn() };
+		return { request(Put, path(Routes::messageOwnReaction, { channelID, messageID, convertEmojiToURL(emoji) }), settings), EmptyRespFn() };
 	}
 
 	BoolResponse BaseDiscordClient::removeReaction(Snowflake<Channel> channelID, Snowflake<Message> messageID, std::string emoji, Snowflake<User> userID) {
-		return { request(Delete, path("channels/{channel.id}/messages/{message.id}/reactions/{emoji}/{user.id}", { channelID, messageID, convertEmojiToURL(emoji), userID })), EmptyRespFn() };
+		return { request(Delete, path(Routes::messageUserReaction, { channelID, messageID, convertEmojiToURL(emoji), userID })), EmptyRespFn() };
 	}
 
 	ArrayResponse<User> BaseDiscordClient::getReactions(Snowflake<Channel> channelID, Snowflake<Message> messageID, std::string emoji, RequestSettings<ArrayResponse<Reaction>> settings) {
-		return ArrayResponse<User>{ request(Get, path("channels/{channel.id}/messages/{message.id}/reactions/{emoji}", { channelID, messageID, convertEmojiToURL(emoji) }), settings) };
+		return ArrayResponse<User>{ request(Get, path(Routes::messageReaction, { channelID, messageID, convertEmojiToURL(emoji) }), settings) };
 	}
 
 	StandardResponse BaseDiscordClient::removeAllReactions(Snowflake<Channel> channelID, Snowflake<Message> messageID, RequestSettings<StandardResponse> settings) {
-		return StandardResponse{ request(Delete, path("channels/{channel.id}/messages/{message.id}/reactions", { channelID, messageID }), settings) };
+		return StandardResponse{ request(Delete, path(Routes::messageReactions, { channelID, messageID }), settings) };
 	}
 
 	BoolResponse BaseDiscordClient::editChannelPermissions(Snowflake<Channel> channelID, Snowflake<Overwrite> overwriteID, int allow, int deny, std::string type) {
 		return { request(
 			Put,
-			path("channels/{channel.id}/permissions/{overwrite.id}", { channelID, overwriteID }),
+			path(Routes::channelPermission, { channelID, overwriteID }),
 			json::createJSON({
 				{ "allow", std::to_string(allow) },
 				{ "deny", std::to_string(deny) },
@@ -179,12 +179,12 @@ namespace SleepyDiscord {
 	}
 
 	ArrayResponse<Invite> BaseDiscordClient::getChannelInvites(Snowflake<Channel> channelID, RequestSettings<ArrayResponse<Invite>> settings) {
-		return ArrayResponse<Invite>{ request(Get, path("channels/{channel.id}/invites", { channelID }), settings) };
+		return ArrayResponse<Invite>{ request(Get, path(Routes::channelInvites, { channelID }), settings) };
 	}
 
 	ObjectResponse<Invite> BaseDiscordClient::createChannelInvite(Snowflake<Channel> channelID, const uint64_t maxAge, const uint64_t maxUses, const bool temporary, const bool unique) {
 		return ObjectResponse<Invite>{
-			request(Post, path("channels/{channel.id}/invites", { channelID }),
+			request(Post, path(Routes::channelInvites, { channelID }),
 				json::createJSON({
 					{"max_age", json::optionalUInteger(maxAge) },
 					{"max_uses", json::optionalUInteger(maxUses) },
@@ -196,31 +196,31 @@ namespace SleepyDiscord {
 	}
 
 	BoolResponse BaseDiscordClient::removeChannelPermission(Snowflake<Channel> channelID, std::string ID, RequestSettings<BoolResponse> settings) {
-		return { request(Delete, path("channels/{channel.id}/permissions/{overwrite.id}", { channelID, ID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::channelPermission, { channelID, ID }), settings), EmptyRespFn() };
 	}
 
 	BoolResponse BaseDiscordClient::sendTyping(Snowflake<Channel> channelID, RequestSettings<BoolResponse> settings) {
-		return { request(Post, path("channels/{channel.id}/typing", { channelID }), settings), EmptyRespFn() };
+		return { request(Post, path(Routes::channelTyping, { channelID }), settings), EmptyRespFn() };
 	}
 
 	ArrayResponse<Message> BaseDiscordClient::getPinnedMessages(Snowflake<Channel> channelID, RequestSettings<ArrayResponse<Message>> settings) {
-		return ArrayResponse<Message>{ request(Get, path("channels/{channel.id}/pins", { channelID }), settings) };
+		return ArrayResponse<Message>{ request(Get, path(Routes::channelPins, { channelID }), settings) };
 	}
 
 	BoolResponse BaseDiscordClient::pinMessage(Snowflake<Channel> channelID, Snowflake<Message> messageID, RequestSettings<BoolResponse> settings) {
-		return { request(Put, path("channels/{channel.id}/pins/{message.id}", { channelID, messageID }), settings), EmptyRespFn() };
+		return { request(Put, path(Routes::channelPin, { channelID, messageID }), settings), EmptyRespFn() };
 	}
 
 	BoolResponse BaseDiscordClient::unpinMessage(Snowflake<Channel> channelID, Snowflake<Message> messageID, RequestSettings<BoolResponse> settings) {
-		return { request(Delete, path("channels/{channel.id}/pins/{message.id}", { channelID, messageID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::channelPin, { channelID, messageID }), settings), EmptyRespFn() };
 	}
 
 	StandardResponse BaseDiscordClient::addRecipient(Snowflake<Channel> channelID, Snowflake<User> userID, RequestSettings<StandardResponse> settings) {
-		return StandardResponse{ request(Put, path("channels/{channel.id}/recipients/{user.id}", { channelID, userID }), settings) };
+		return StandardResponse{ request(Put, path(Routes::channelRecipient, { channelID, userID }), settings) };
 	}
 
 	StandardResponse BaseDiscordClient::removeRecipient(Snowflake<Channel> channelID, Snowflake<User> userID, RequestSettings<StandardResponse> settings) {
-		return StandardResponse{ request(Delete, path("channels/{channel.id}/recipients/{user.id}", { channelID, userID }), settings) };
+		return StandardResponse{ request(Delete, path(Routes::channelRecipient, { channelID, userID }), settings) };
 	}
 
 	//
@@ -228,22 +228,22 @@ namespace SleepyDiscord {
 	//
 	ObjectResponse<Channel> BaseDiscordClient::createTextChannel(Snowflake<Server> serverID, std::string name, RequestSettings<ObjectResponse<Channel>> settings) {
 		return ObjectResponse<Channel>{
-			request(Post, path("guilds/{guild.id}/channels", { serverID }), settings, "{\"name\": " + json::string(name) + ", \"type\": 0}")
+			request(Post, path(Routes::serverChannels, { serverID }), settings, "{\"name\": " + json::string(name) + ", \"type\": 0}")
 		};
 	}
 
 	ObjectResponse<Channel> BaseDiscordClient::createChannel(Snowflake<Server> serverID, std::string name, Channel::ChannelType ChannelType, RequestSettings<ObjectResponse<Channel>> settings) {
 		return ObjectResponse<Channel>{
-			request(Post, path("guilds/{guild.id}/channels", { serverID }), settings, "{\"name\": " + json::string(name) + ", \"type\": "+ std::to_string(ChannelType) +"}")
+			request(Post, path(Routes::serverChannels, { serverID }), settings, "{\"name\": " + json::string(name) + ", \"type\": "+ std::to_string(ChannelType) +"}")
 		};
 	}
 
 	ArrayResponse<Channel> BaseDiscordClient::editChannelPositions(Snowflake<Server> serverID, std::vector<std::pair<std::string, uint64_t>> positions, RequestSettings<ArrayResponse<Channel>> settings) {
-		return ArrayResponse<Channel>{ request(Patch, path("guilds/{guild.id}/channels", { serverID }), getEditPositionString(positions)) };
+		return ArrayResponse<Channel>{ request(Patch, path(Routes::serverChannels, { serverID }), getEditPositionString(positions)) };
 	}
 
 	ObjectResponse<ServerMember> SleepyDiscord::BaseDiscordClient::getMember(Snowflake<Server> serverID, Snowflake<User> userID, RequestSettings<ObjectResponse<ServerMember>> settings) {
-		return ObjectResponse<ServerMember>{ request(Get, path("guilds/{guild.id}/members/{user.id}", { serverID, userID }), settings) };
+		return ObjectResponse<ServerMember>{ request(Get, path(Routes::serverMember, { serverID, userID }), settings) };
 	}
 
 	ArrayResponse<ServerMember> BaseDiscordClient::listMembers(Snowflake<Server> serverID, uint16_t limit, std::string after, RequestSettings<ArrayResponse<ServerMember>> settings) {
@@ -252,7 +252,7 @@ namespace SleepyDiscord {
 		std::string afterParm = after != "" ? "after=" + after : "";
 		if (afterParm != "" && limitParm != "") limitParm += '&';
 		else if (afterParm != "" && limitParm == "") limitParm += '?';
-		return ArrayResponse<ServerMember>{ request(Get, path("guilds/{guild.id}/members{limit}{after}", { serverID, limitParm, afterParm }), settings) };
+		return ArrayResponse<ServerMember>{ request(Get, path(Routes::serverMembersQuery, { serverID, limitParm, afterParm }), settings) };
 	}
 
 	ObjectResponse<ServerMember> BaseDiscordClient::addMember(Snowflake<Server> serverID, Snowflake<User> userID, std::string accesToken, std::string nick, std::vector<Role> roles, bool mute, bool deaf) {
@@ -277,7 +277,7 @@ namespace SleepyDiscord {
 		}
 
 		return ObjectResponse<ServerMember>{
-			request(Put, path("guilds/{guild.id}/members/{user.id}"), json::createJSON({
+			request(Put, path(Routes::serverMember), json::createJSON({
 				{ "access_token", json::string (accesToken) },
 				{ "nick"        , json::string (nick)       },
 				{ "roles"       , rolesString               },
@@ -291,7 +291,7 @@ namespace SleepyDiscord {
 		const std::string muteString = mute != -1 ? json::boolean(mute) : "";
 		const std::string deafString = deaf != -1 ? json::boolean(deaf) : "";
 
-		return { request(Patch, path("guilds/{guild.id}/members/{user.id}", { serverID, userID }), json::createJSON({
+		return { request(Patch, path(Routes::serverMember, { serverID, userID }), json::createJSON({
 			{ "nick"      , json::string(nickname)       },
 			{ "roles"     , json::createJSONArray(roles) },
 			{ "mute"      , muteString                   },
@@ -301,7 +301,7 @@ namespace SleepyDiscord {
 	}
 
 	ArrayResponse<Role> BaseDiscordClient::editRolePosition(Snowflake<Server> serverID, std::vector<std::pair<std::string, uint64_t>> positions, RequestSettings<ArrayResponse<Role>> settings) {
-		return ArrayResponse<Role>{ request(Patch, path("guilds/{guild.id}/roles", { serverID }), settings, getEditPositionString(positions)) };
+		return ArrayResponse<Role>{ request(Patch, path(Routes::serverRoles, { serverID }), settings, getEditPositionString(positions)) };
 	}
 
 
@@ -311,7 +311,7 @@ namespace SleepyDiscord {
 		const std::string mentionableString = mentionable >> 1  == 0 ? json::boolean (mentionable) : "";
 
 		return StringResponse{
-			request(Patch, path("guilds/{guild.id}/roles/{role.id}", { serverID, roleID }), json::createJSON({
+			request(Patch, path(Routes::serverRole, { serverID, roleID }), json::createJSON({
 				{ "name"       , json::string(name)         },
 				{ "permissions", json::integer(permissions) },
 				{ "color"      , colorString                },
@@ -322,16 +322,16 @@ namespace SleepyDiscord {
 	}
 
 	BoolResponse SleepyDiscord::BaseDiscordClient::deleteRole(Snowflake<Server> serverID, Snowflake<Role> roleID, RequestSettings<BoolResponse> settings) {
-		return { request(Delete, path("guilds/{guild.id}/roles/{role.id}", { serverID, roleID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::serverRole, { serverID, roleID }), settings), EmptyRespFn() };
 	}
 
 	BoolResponse BaseDiscordClient::muteServerMember(Snowflake<Server> serverID, Snowflake<User> userID, bool mute, RequestSettings<BoolResponse> settings) {
-		return { request(Patch, path("guilds/{guild.id}/members/{user.id}", { serverID, userID }), settings, mute ? "{\"mute\":true}" : "{\"mute\":false}"), EmptyRespFn() };
+		return { request(Patch, path(Routes::serverMember, { serverID, userID }), settings, mute ? "{\"mute\":true}" : "{\"mute\":false}"), EmptyRespFn() };
 	}
 
 	//needs ablily to turn channel into json
 	/*ObjectResponse<Server> BaseDiscordClient::createServer(std::string name, std::string region, std::string icon, int verificationLevel, int defaultMessageNotifications, int explicitContentLevel, std::vector<Role> roles, std::vector<Channel> channels) {
-		request(Post, "guilds", json::createJSON({
+		request(Post, Routes::servers, json::createJSON({
 			{ "name"                         , json::string (name) },
 			{ "region"                       , json::string(region) },
 			{ "icon"                         , json::string(icon) },
@@ -344,35 +344,35 @@ namespace SleepyDiscord {
 	}*/
 
 	ObjectResponse<Server> BaseDiscordClient::getServer(Snowflake<Server> serverID, RequestSettings<ObjectResponse<Server>> settings) {
-		return ObjectResponse<Server>{ request(Get, path("guilds/{guild.id}", { serverID }), settings) };
+		return ObjectResponse<Server>{ request(Get, path(Routes::server, { serverID }), settings) };
 	}
 
 	ObjectResponse<Server> BaseDiscordClient::deleteServer(Snowflake<Server> serverID, RequestSettings<ObjectResponse<Server>> settings) {
-		return ObjectResponse<Server>{ request(Delete, path("guilds/{guild.id}", { serverID }), settings) };
+		return ObjectResponse<Server>{ request(Delete, path(Routes::server, { serverID }), settings) };
 	}
 
 	ArrayResponse<Channel> SleepyDiscord::BaseDiscordClient::getServerChannels(Snowflake<Server> serverID, RequestSettings<ArrayResponse<Channel>> settings) {
-		return ArrayResponse<Channel>{ request(Get, path("guilds/{guild.id}/channels", { serverID }), settings) };
+		return ArrayResponse<Channel>{ request(Get, path(Routes::serverChannels, { serverID }), settings) };
 	}
 
 	BoolResponse BaseDiscordClient::editNickname(Snowflake<Server> serverID, std::string newNickname, RequestSettings<BoolResponse> settings) {
-		return { request(Patch, path("guilds/{guild.id}/members/@me/nick", { serverID }), settings, "{\"nick\":" + json::string(newNickname) + "}"), StandardRespFn() };
+		return { request(Patch, path(Routes::serverOwnNickname, { serverID }), settings, "{\"nick\":" + json::string(newNickname) + "}"), StandardRespFn() };
 	}
 
 	BoolResponse BaseDiscordClient::addRole(Snowflake<Server> serverID, Snowflake<User> userID, Snowflake<Role> roleID, RequestSettings<BoolResponse> settings) {
-		return { request(Put, path("guilds/{guild.id}/members/{user.id}/roles/{role.id}", { serverID, userID, roleID }), settings), EmptyRespFn() };
+		return { request(Put, path(Routes::serverMemberRole, { serverID, userID, roleID }), settings), EmptyRespFn() };
 	}
 
 	BoolResponse BaseDiscordClient::removeRole(Snowflake<Server> serverID, Snowflake<User> userID, Snowflake<Role> roleID, RequestSettings<BoolResponse> settings) {
-		return { request(Delete, path("guilds/{guild.id}/members/{user.id}/roles/{role.id}", { serverID, userID, roleID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::serverMemberRole, { serverID, userID, roleID }), settings), EmptyRespFn() };
 	}
 
 	BoolResponse BaseDiscordClient::kickMember(Snowflake<Server> serverID, Snowflake<User> userID, RequestSettings<BoolResponse> settings) {
-		return { request(Delete, path("guilds/{guild.id}/members/{user.id}", { serverID, userID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::serverMember, { serverID, userID }), settings), EmptyRespFn() };
 	}
 
 	ArrayResponse<User> BaseDiscordClient::getBans(Snowflake<Server> serverID, RequestSettings<ArrayResponse<User>> settings) {
-		return ArrayResponse<User>{ request(Get, path("guilds/{guild.id}/bans", { serverID }), settings) };
+		return ArrayResponse<User>{ request(Get, path(Routes::serverBans, { serverID }), settings) };
 	}
 
 	BoolResponse BaseDiscordClient::banMember(Snowflake<Server> serverID, Snowflake<User> userID, int deleteMessageDays, std::string reason, RequestSettings<BoolResponse> settings) {
@@ -386,20 +386,20 @@ namespace SleepyDiscord {
 			reasonValue.SetString(reason.c_str(), reason.length());
 			doc.AddMember("reason", reasonValue, allocator);
 		}
-		return { request(Put, path("guilds/{guild.id}/bans/{user.id}", { serverID, userID }), settings, json::stringify(doc)), EmptyRespFn() };
+		return { request(Put, path(Routes::serverBan, { serverID, userID }), settings, json::stringify(doc)), EmptyRespFn() };
 	}
 
 	BoolResponse BaseDiscordClient::unbanMember(Snowflake<Server> serverID, Snowflake<User> userID, RequestSettings<BoolResponse> settings) {
-		return { request(Delete, path("guilds/{guild.id}/bans/{user.id}", { serverID, userID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::serverBan, { serverID, userID }), settings), EmptyRespFn() };
 	}
 
 	ArrayResponse<Role> BaseDiscordClient::getRoles(Snowflake<Server> serverID, RequestSettings<ArrayResponse<Role>> settings) {
-		return ArrayResponse<Role>{ request(Get, path("guilds/{guild.id}/roles", { serverID }), settings) };
+		return ArrayResponse<Role>{ request(Get, path(Routes::serverRoles, { serverID }), settings) };
 	}
 
 	ObjectResponse<Role> BaseDiscordClient::createRole(Snowflake<Server> serverID, std::string name, Permission permissions, unsigned int color, bool hoist, bool mentiionable) {
 		return ObjectResponse<Role>{
-			request(Post, path("guilds/{guild.id}/roles", { serverID }), json::createJSON({
+			request(Post, path(Routes::serverRoles, { serverID }), json::createJSON({
 				{ "name"       , json::string (name        ) },
 				{ "permissions", json::integer(permissions ) },
 				{ "color"      , json::integer(color       ) },
@@ -411,30 +411,30 @@ namespace SleepyDiscord {
 
 	StandardResponse BaseDiscordClient::pruneMembers(Snowflake<Server> serverID, const unsigned int numOfDays, RequestSettings<StandardResponse> settings) {
 		if (numOfDays == 0) return StandardResponse{ BAD_REQUEST };
-		return StandardResponse{ request(Post, path("guilds/{guild.id}/prune", { serverID }), settings, "{\"days\":" + std::to_string(numOfDays) + '}') };
+		return StandardResponse{ request(Post, path(Routes::serverPrune, { serverID }), settings, "{\"days\":" + std::to_string(numOfDays) + '}') };
 	}
 
 	ArrayResponse<VoiceRegion> BaseDiscordClient::getVoiceRegions(RequestSettings<ArrayResponse<VoiceRegion>> settings) {
-		return ArrayResponse<VoiceRegion>{ request(Get, path("guilds/{guild.id}/regions"), settings) };
+		return ArrayResponse<VoiceRegion>{ request(Get, path(Routes::serverRegions), settings) };
 	}
 
 	ArrayResponse<Invite> BaseDiscordClient::getServerInvites(Snowflake<Server> serverID, RequestSettings<ArrayResponse<Invite>> settings) {
-		return ArrayResponse<Invite>{ request(Get, path("guilds/{guild.id}/invites", { serverID }), settings) };
+		return ArrayResponse<Invite>{ request(Get, path(Routes::serverInvites, { serverID }), settings) };
 	}
 
 	StringResponse BaseDiscordClient::getIntegrations(Snowflake<Server> serverID, RequestSettings<StringResponse> settings) {
-		return StringResponse{ request(Get, path("guilds/{guild.id}/integrations", { serverID }), settings) };
+		return StringResponse{ request(Get, path(Routes::serverIntegrations, { serverID }), settings) };
 	}
 
 	BoolResponse BaseDiscordClient::createIntegration(Snowflake<Server> serverID, std::string type, std::string integrationID, RequestSettings<BoolResponse> settings) {
-		return { request(Post, path("guilds/{guild.id}/integrations", { serverID }), settings, json::createJSON({
+		return { request(Post, path(Routes::serverIntegrations, { serverID }), settings, json::createJSON({
 			{ "type", json::string(type) },
 			{ "id", json::string(integrationID) }
 		})), EmptyRespFn() };
 	}
 
 	BoolResponse BaseDiscordClient::editIntergration(Snowflake<Server> serverID, std::string integrationID, int expireBegavior, int expireGracePeriod, bool enbleEmoticons) {
-		return { request(Patch, path("guilds/{guild.id}/integrations/{integration.id}", { serverID, integrationID }), json::createJSON({
+		return { request(Patch, path(Routes::serverIntegration, { serverID, integrationID }), json::createJSON({
 			{ "expire_behavior", json::integer(expireBegavior) },
 			{ "expire_grace_period", json::integer(expireGracePeriod) },
 			{ "enable_emoticons", json::boolean(enbleEmoticons) }
@@ -442,22 +442,22 @@ namespace SleepyDiscord {
 	}
 
 	BoolResponse BaseDiscordClient::deleteIntegration(Snowflake<Server> serverID, std::string integrationID, RequestSettings<BoolResponse> settings) {
-		return { request(Delete, path("guilds/{guild.id}/integrations/{integration.id}", { serverID, integrationID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::serverIntegration, { serverID, integrationID }), settings), EmptyRespFn() };
 	}
 
 	BoolResponse BaseDiscordClient::syncIntegration(Snowflake<Server> serverID, std::string integrationID, RequestSettings<BoolResponse> settings) {
-		return { request(Post, path("guilds/{guild.id}/integrations/{integration.id}/sync", { serverID, integrationID }), settings), EmptyRespFn() };
+		return { request(Post, path(Routes::serverIntegrationSync, { serverID, integrationID }), settings), EmptyRespFn() };
 	}
 
 	ObjectResponse<ServerWidget> BaseDiscordClient::getServerWidget(Snowflake<Server> serverID, RequestSettings<ObjectResponse<ServerWidget>> settings) {
-		return ObjectResponse<ServerWidget>{ request(Get, path("guilds/{guild.id}/widget", { serverID }), settings) };
+		return ObjectResponse<ServerWidget>{ request(Get, path(Routes::serverWidget, { serverID }), settings) };
 	}
 
 	//
 	//Invite functions
 	//
 	ObjectResponse<Invite> BaseDiscordClient::inviteEndpoint(RequestMethod method, std::string inviteCode, RequestSettings<ObjectResponse<Invite>> settings) {
-		return ObjectResponse<Invite>{ request(method, path("invites/{invite.code}", { inviteCode }), settings) };
+		return ObjectResponse<Invite>{ request(method, path(Routes::invite, { inviteCode }), settings) };
 	}
 
 	ObjectResponse<Invite> BaseDiscordClient::getInvite(std::string inviteCode, RequestSettings<ObjectResponse<Invite>> settings) {
@@ -475,53 +475,53 @@ namespace SleepyDiscord {
 	//User functions
 	//
 	ObjectResponse<User> BaseDiscordClient::getCurrentUser(RequestSettings<ObjectResponse<User>> settings) {
-		return ObjectResponse<User>{ request(Get, "users/@me", settings) };
+		return ObjectResponse<User>{ request(Get, Routes::currentUser, settings) };
 	}
 
 	ObjectResponse<User> BaseDiscordClient::getUser(Snowflake<User> userID, RequestSettings<ObjectResponse<User>> settings) {
-		return ObjectResponse<User>{ request(Get, path("users/{user.id}", { userID }), settings) };
+		return ObjectResponse<User>{ request(Get, path(Routes::user, { userID }), settings) };
 	}
 
 	ArrayResponse<Server> BaseDiscordClient::getServers(RequestSettings<ArrayResponse<Server>> settings) {
-		return ArrayResponse<Server>{ request(Get, "users/@me/guilds", settings) };
+		return ArrayResponse<Server>{ request(Get, Routes::currentUserServers, settings) };
 	}
 
 	BoolResponse BaseDiscordClient::leaveServer(Snowflake<Server> serverID, RequestSettings<BoolResponse> settings) {
-		return { request(Delete, path("users/@me/guilds/{guild.id}", { serverID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::currentUserServer, { serverID }), settings), EmptyRespFn() };
 	}
 
 	ArrayResponse<Channel> BaseDiscordClient::getDirectMessageChannels(RequestSettings<ArrayResponse<Channel>> settings) {
-		return ArrayResponse<Channel>{ request(Get, "users/@me/channels", settings) };
+		return ArrayResponse<Channel>{ request(Get, Routes::currentUserChannels, settings) };
 	}
 
 	ObjectResponse<Channel> BaseDiscordClient::createDirectMessageChannel(std::string recipientID, RequestSettings<ObjectResponse<Channel>> settings) {
-		return ObjectResponse<Channel>{ request(Post, "users/@me/channels", settings, json::createJSON({ { "recipient_id", recipientID } })) };
+		return ObjectResponse<Channel>{ request(Post, Routes::currentUserChannels, settings, json::createJSON({ { "recipient_id", recipientID } })) };
 	}
 
 	ArrayResponse<Connection> BaseDiscordClient::getUserConnections(RequestSettings<ArrayResponse<Connection>> settings) {
-		return ArrayResponse<Connection>{ request(Get, "users/@me/connections", settings) };
+		return ArrayResponse<Connection>{ request(Get, Routes::currentUserConnections, settings) };
 	}
 
 	//
 	//Webhook functions
 	//
 	ObjectResponse<Webhook> BaseDiscordClient::createWebhook(Snowflake<Channel> channelID, std::string name, std::string avatar, RequestSettings<ObjectResponse<Webhook>> settings) {
-		return ObjectResponse<Webhook>{ request(Post, path("channels/{channel.id}/webhooks", { channelID }), settings, json::createJSON({
+		return ObjectResponse<Webhook>{ request(Post, path(Routes::channelWebhooks, { channelID }), settings, json::createJSON({
 			{"name", json::string(name)},
 			{"avatar", json::string(avatar)}
 		})) };
 	}
 
 	ArrayResponse<Webhook> BaseDiscordClient::getChannelWebhooks(Snowflake<Channel> channelID, RequestSettings<ArrayResponse<Webhook>> settings) {
-		return ArrayResponse<Webhook>{ request(Get, path("channels/{channel.id}/webhooks", { channelID }), settings) };
+		return ArrayResponse<Webhook>{ request(Get, path(Routes::channelWebhooks, { channelID }), settings) };
 	}
 
 	ArrayResponse<Webhook> BaseDiscordClient::getServerWebhooks(Snowflake<Server> serverID, RequestSettings<ArrayResponse<Webhook>> settings) {
-		return ArrayResponse<Webhook>{ request(Get, path("guilds/{guild.id}/webhooks", { serverID }), settings) };
+		return ArrayResponse<Webhook>{ request(Get, path(Routes::serverWebhooks, { serverID }), settings) };
 	}
 
-	inline const char* optionalWebhookToken(std::string webhookToken) {
-		return webhookToken != "" ? "webhooks/{webhook.id}/{webhook.token}" : "webhooks/{webhook.id}";
+	inline const RouteTemplate& optionalWebhookToken(std::string webhookToken) {
+		return webhookToken != "" ? Routes::webhookWithToken : Routes::webhook;
 	}
 
 	ObjectResponse<Webhook> BaseDiscordClient::getWebhook(Snowflake<Webhook> webhookID, std::string webhookToken, RequestSettings<ObjectResponse<Webhook>> settings) {
@@ -543,7 +543,7 @@ namespace SleepyDiscord {
 
 	ObjectResponse<Webhook> BaseDiscordClient::requestExecuteWebhook(Snowflake<Webhook> webhookID, std::string webhookToken, std::pair<std::string, std::string> pair, bool wait, std::string username, std::string avatar_url, bool tts) {
 		return ObjectResponse<Webhook>{
-			request(Post, path("webhooks/{webhook.id}/{webhook.token}{wait}", { webhookID, webhookToken, (wait ? "?around=true" : "") }), json::createJSON({
+			request(Post, path(Routes::executeWebhook, { webhookID, webhookToken, (wait ? "?around=true" : "") }), json::createJSON({
 				pair,
 				{ "username"  , json::string(username  ) },
 				{ "avatar_url", json::string(avatar_url) },
@@ -561,7 +561,7 @@ namespace SleepyDiscord {
 	//}
 	
 	ObjectResponse<Webhook> BaseDiscordClient::executeWebhook(Snowflake<Webhook> webhookID, std::string webhookToken, filePathPart file, bool /*wait*/, std::string username, std::string avatar_url, bool tts) {
-		return ObjectResponse<Webhook>{ request(Post, path("webhooks/{webhook.id}/{webhook.token}", { webhookID, webhookToken }), "", {
+		return ObjectResponse<Webhook>{ request(Post, path(Routes::webhookWithToken, { webhookID, webhookToken }), "", {
 			{ "file"      , filePathPart(file)  },
 			{ "username"  , username            },
 			{ "avatar_url", avatar_url          },
@@ -569,77 +569,77 @@ namespace SleepyDiscord {
 		}) };
 	}
 
-	ArrayResponse<AppCommand> BaseDiscordClient::getGlobalAppCommands(Snowflake<DiscordObject>::RawType applicationID, RequestSettings<ArrayResponse<AppCommand>> settings) {
-		return ArrayResponse<AppCommand>{ request(Get, path("applications/{application.id}/commands", { applicationID }), settings) };
+	ArrayResponse<AppCommand> BaseDiscordClient::getGlobalAppCommands(Snowflake<DiscordObject> applicationID, RequestSettings<ArrayResponse<AppCommand>> settings) {
+		return ArrayResponse<AppCommand>{ request(Get, path(Routes::globalAppCommands, { applicationID }), settings) };
 	}
 
 	ObjectResponse<AppCommand> BaseDiscordClient::getGlobalAppCommand(
-		Snowflake<DiscordObject>::RawType applicationID, Snowflake<AppCommand> commandID,
+		Snowflake<DiscordObject> applicationID, Snowflake<AppCommand> commandID,
 		RequestSettings<ObjectResponse<AppCommand>> settings
 	) {
-		return ObjectResponse<AppCommand>{ request(Get, path("applications/{application.id}/commands/{command.id}", { applicationID, commandID }), settings) };
+		return ObjectResponse<AppCommand>{ request(Get, path(Routes::globalAppCommand, { applicationID, commandID }), settings) };
 	}
 
 	BoolResponse BaseDiscordClient::deleteGlobalAppCommand(
-		Snowflake<DiscordObject>::RawType applicationID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings
+		Snowflake<DiscordObject> applicationID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings
 	) {
-		return { request(Delete, path("applications/{application.id}/commands/{command.id}", { applicationID, commandID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::globalAppCommand, { applicationID, commandID }), settings), EmptyRespFn() };
 	}
 
 	ArrayResponse<AppCommand> BaseDiscordClient::getServerAppCommands(
-		Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<AppCommand>> settings
+		Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<AppCommand>> settings
 	) {
-		return ArrayResponse<AppCommand>{ request(Get, path("applications/{application.id}/guilds/{guild.id}/commands", { applicationID, serverID }), settings) };
+		return ArrayResponse<AppCommand>{ request(Get, path(Routes::serverAppCommands, { applicationID, serverID }), settings) };
 	}
 
 	ObjectResponse<AppCommand> BaseDiscordClient::getServerAppCommand(
-		Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID,
+		Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID,
 		RequestSettings<ObjectResponse<AppCommand>> settings
 	) {
-		return ObjectResponse<AppCommand>{ request(Get, path("applications/{application.id}/guilds/{guild.id}/commands/{command.id}", { applicationID, serverID, commandID }), settings) };
+		return ObjectResponse<AppCommand>{ request(Get, path(Routes::serverAppCommand, { applicationID, serverID, commandID }), settings) };
 	}
 
 	BoolResponse BaseDiscordClient::deleteServerAppCommand(
-		Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings
+		Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings
 	) {
-		return { request(Delete, path("applications/{application.id}/guilds/{guild.id}/commands/{command.id}", { applicationID, serverID, commandID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::serverAppCommand, { applicationID, serverID, commandID }), settings), EmptyRespFn() };
 	}
 
 	ObjectResponse<Message> BaseDiscordClient::editOriginalInteractionResponse(
-		Snowflake<DiscordObject>::RawType applicationID, std::string interactionToken, EditWebhookParams params, RequestSettings<BoolResponse> settings
+		Snowflake<DiscordObject> applicationID, std::string interactionToken, EditWebhookParams params, RequestSettings<BoolResponse> settings
 	) {
-		return ObjectResponse<Message>{ request(Patch, path("webhooks/{application.id}/{interaction.token}/messages/@original", { applicationID, interactionToken }), settings, json::stringifyObj(params)) };
+		return ObjectResponse<Message>{ request(Patch, path(Routes::originalInteractionResponse, { applicationID, interactionToken }), settings, json::stringifyObj(params)) };
 	}
 
 	BoolResponse BaseDiscordClient::deleteOriginalInteractionResponse(
-		Snowflake<DiscordObject>::RawType applicationID, std::string interactionToken, RequestSettings<BoolResponse> settings
+		Snowflake<DiscordObject> applicationID, std::string interactionToken, RequestSettings<BoolResponse> settings
 	) {
-		return { request(Delete, path("webhooks/{application.id}/{interaction.token}/messages/@original", { applicationID, interactionToken }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::originalInteractionResponse, { applicationID, interactionToken }), settings), EmptyRespFn() };
 	}
 
 	ObjectResponse<Message> BaseDiscordClient::createFollowupMessage(
-		Snowflake<DiscordObject>::RawType applicationID, std::string interactionToken, FollowupMessage params, RequestSettings<BoolResponse> settings
+		Snowflake<DiscordObject> applicationID, std::string interactionToken, FollowupMessage params, RequestSettings<BoolResponse> settings
 	) {
-		return ObjectResponse<Message>{ request(Post, path("webhooks/{application.id}/{interaction.token}", { applicationID, interactionToken }), settings, json::stringifyObj(params)) };
+		return ObjectResponse<Message>{ request(Post, path(Routes::followupMessages, { applicationID, interactionToken }), settings, json::stringifyObj(params)) };
 	}
 
 	ObjectResponse<Message> BaseDiscordClient::editFollowupMessage(
-		Snowflake<DiscordObject>::RawType applicationID, std::string interactionToken, Snowflake<Message> messageID, EditWebhookParams params, RequestSettings<BoolResponse> settings
+		Snowflake<DiscordObject> applicationID, std::string interactionToken, Snowflake<Message> messageID, EditWebhookParams params, RequestSettings<BoolResponse> settings
 	) {
-		return ObjectResponse<Message>{ request(Patch, path("webhooks/{application.id}/{interaction.token}/messages/{message.id}", { applicationID, interactionToken, messageID }), settings, json::stringifyObj(params)) };
+		return ObjectResponse<Message>{ request(Patch, path(Routes::followupMessage, { applicationID, interactionToken, messageID }), settings, json::stringifyObj(params)) };
 	}
 
 	BoolResponse BaseDiscordClient::deleteFollowupMessage(
-		Snowflake<DiscordObject>::RawType applicationID, std::string interactionToken, Snowflake<Message> messageID, RequestSettings<BoolResponse> settings
+		Snowflake<DiscordObject> applicationID, std::string interactionToken, Snowflake<Message> messageID, RequestSettings<BoolResponse> settings
 	) {
-		return { request(Delete, path("webhooks/{application.id}/{interaction.token}/messages/{message.id}", { applicationID, interactionToken, messageID }), settings), EmptyRespFn() };
+		return { request(Delete, path(Routes::followupMessage, { applicationID, interactionToken, messageID }), settings), EmptyRespFn() };
 	}
 	/// <summary>
 	/// Batch edits permissions for all commands in a guild. Takes an array of partial objects including id and permissions.
 	/// https://discord.com/developers/docs/interactions/slash-commands#batch-edit-application-command-permissions
 	/// </summary>
 	BoolResponse BaseDiscordClient::batchEditAppCommandPermissions(
-		Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, std::vector<ServerAppCommandPermissions> permissions, RequestSettings<BoolResponse> settings
+		Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, std::vector<ServerAppCommandPermissions> permissions, RequestSettings<BoolResponse> settings
 	) {
 		rapidjson::Document doc;
 		doc.SetObject();
@@ -652,14 +652,14 @@ namespace SleepyDiscord {
 			}
 			doc.AddMember("permissions", arr, allocator);
 		}
-		return BoolResponse{ request(Put, path("applications/{application.id}/guilds/{guild.id}/commands/permissions", { applicationID, serverID }), settings , json::stringify(doc)) };
+		return BoolResponse{ request(Put, path(Routes::serverAppCommandsPermissions, { applicationID, serverID }), settings , json::stringify(doc)) };
 	}
 	/// <summary>
 	/// Edits command permissions for a specific command for your application in a guild.
 	/// https://discord.com/developers/docs/interactions/slash-commands#edit-application-command-permissions
 	/// </summary>
 	BoolResponse BaseDiscordClient::editServerAppCommandPermission(
-		Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, std::vector<AppCommand::Permissions> permissions, RequestSettings<BoolResponse> settings
+		Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, std::vector<AppCommand::Permissions> permissions, RequestSettings<BoolResponse> settings
 	) {
 		rapidjson::Document doc;
 		doc.SetObject();
@@ -669,60 +669,60 @@ namespace SleepyDiscord {
 			arr.PushBack(json::toJSON(permission, allocator), allocator);
 		}
 		doc.AddMember("permissions", arr, allocator);
-		return BoolResponse{ request(Put, path("applications/{application.id}/guilds/{guild.id}/commands/{command.id}/permissions", { applicationID, serverID, commandID }), settings , json::stringify(doc)) };
+		return BoolResponse{ request(Put, path(Routes::serverAppCommandPermissions, { applicationID, serverID, commandID }), settings , json::stringify(doc)) };
 	}
 	/// <summary>
 	/// Fetches command permissions for all commands for your application in a guild.
 	/// https://discord.com/developers/docs/interactions/slash-commands#get-guild-application-command-permissions
 	/// </summary>
 	ArrayResponse<ServerAppCommandPermissions> BaseDiscordClient::getServerAppCommandPermissions(
-		Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<ServerAppCommandPermissions>> settings
+		Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<ServerAppCommandPermissions>> settings
 	) {
-		return ArrayResponse<ServerAppCommandPermissions>{ request(Get, path("applications/{application.id}/guilds/{guild.id}/commands/permissions", { applicationID, serverID }), settings) };
+		return ArrayResponse<ServerAppCommandPermissions>{ request(Get, path(Routes::serverAppCommandsPermissions, { applicationID, serverID }), settings) };
 	}
 	/// <summary>
 	/// Fetches command permissions for a specific command for your application in a guild.
 	/// https://discord.com/developers/docs/interactions/slash-commands#get-application-command-permissions
 	/// </summary>
 	ObjectResponse<ServerAppCommandPermissions> BaseDiscordClient::getAppCommandPermissions(
-		Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<ServerAppCommandPermissions>> settings
+		Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<ServerAppCommandPermissions>> settings
 	) {
-		return ObjectResponse<ServerAppCommandPermissions>{ request(Get, path("applications/{application.id}/guilds/{guild.id}/commands/{command.id}/permissions", { applicationID, serverID, commandID }), settings) };
+		return ObjectResponse<ServerAppCommandPermissions>{ request(Get, path(Routes::serverAppCommandPermissions, { applicationID, serverID, commandID }), settings) };
 	}
 
-	ArrayResponse<AppCommand> BaseDiscordClient::getAppCommands(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<AppCommand>> settings) {
+	ArrayResponse<AppCommand> BaseDiscordClient::getAppCommands(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, RequestSettings<ArrayResponse<AppCommand>> settings) {
 		if (serverID.empty()) return getGlobalAppCommands(applicationID, settings);
 		return getServerAppCommands(applicationID, serverID, settings);
 	}
 
-	ObjectResponse<AppCommand> BaseDiscordClient::getAppCommand(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<AppCommand>> settings) {
+	ObjectResponse<AppCommand> BaseDiscordClient::getAppCommand(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<ObjectResponse<AppCommand>> settings) {
 		if (serverID.empty()) return getGlobalAppCommand(applicationID, commandID, settings);
 		return getServerAppCommand(applicationID, serverID, commandID,  settings);
 	}
 
-	BoolResponse BaseDiscordClient::deleteAppCommand(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings) {
+	BoolResponse BaseDiscordClient::deleteAppCommand(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, Snowflake<AppCommand> commandID, RequestSettings<BoolResponse> settings) {
 		if (serverID.empty()) return deleteGlobalAppCommand(applicationID, commandID, settings);
 		return deleteServerAppCommand(applicationID, serverID, commandID, settings);
 	}
 
-	BoolResponse BaseDiscordClient::bulkOverwriteServerAppCommands(Snowflake<DiscordObject>::RawType applicationID, Snowflake<Server> serverID, std::vector<AppCommand> commands, RequestSettings<BoolResponse> settings) {
+	BoolResponse BaseDiscordClient::bulkOverwriteServerAppCommands(Snowflake<DiscordObject> applicationID, Snowflake<Server> serverID, std::vector<AppCommand> commands, RequestSettings<BoolResponse> settings) {
 		rapidjson::Document doc;
 		doc.SetArray();
 		auto& allocator = doc.GetAllocator();
 		for (auto& command : commands) {
 			doc.PushBack(json::toJSON(command, allocator), allocator);
 		}
-		return BoolResponse{ request(Put, path("applications/{application.id}/guilds/{guild.id}/commands", {applicationID, serverID}), settings, json::stringify(doc)) };
+		return BoolResponse{ request(Put, path(Routes::serverAppCommands, {applicationID, serverID}), settings, json::stringify(doc)) };
 	}
 
-	BoolResponse BaseDiscordClient::bulkOverwriteGlobalAppCommands(Snowflake<DiscordObject>::RawType applicationID, std::vector<AppCommand> commands, RequestSettings<BoolResponse> settings) {
+	BoolResponse BaseDiscordClient::bulkOverwriteGlobalAppCommands(Snowflake<DiscordObject> applicationID, std::vector<AppCommand> commands, RequestSettings<BoolResponse> settings) {
 		rapidjson::Document doc;
 		doc.SetArray();
 		auto& allocator = doc.GetAllocator();
 		for (auto& command : commands) {
 			doc.PushBack(json::toJSON(command, allocator), allocator);
 		}
-		return BoolResponse{ request(Put, path("applications/{application.id}/commands", {applicationID}), settings, json::stringify(doc)) };
+		return BoolResponse{ request(Put, path(Routes::globalAppCommands, {applicationID}), settings, json::stringify(doc)) };
 	}
 
 	ObjectResponse<User> BaseDiscordClient::createStageInstance(Snowflake<Channel> channelID, std::string topic, StageInstance::PrivacyLevel privacyLevel, RequestSettings<ObjectResponse<User>> settings) {
@@ -735,12 +735,12 @@ namespace SleepyDiscord {
 		if (privacyLevel != StageInstance::PrivacyLevel::NotSet)
 			doc.AddMember("privacy_level", static_cast<StageInstance::PrivacyLevelRaw>(privacyLevel), allocator);
 		return ObjectResponse<User>{
-			request(Post, path("/stage-instances", {}), settings, json::stringify(doc))
+			request(Post, path(Routes::stageInstances, {}), settings, json::stringify(doc))
 		};
 	}
 
 	ObjectResponse<StageInstance> BaseDiscordClient::getStageInstance(Snowflake<Channel> channelID, RequestSettings<ObjectResponse<StageInstance>> settings) {
-		return ObjectResponse<StageInstance>{ request(Get, path("/stage-instances/{channel.id}", { channelID }), settings)};
+		return ObjectResponse<StageInstance>{ request(Get, path(Routes::stageInstance, { channelID }), settings)};
 	}
 
 	BoolResponse BaseDiscordClient::editStageInstance(Snowflake<Channel> channelID, std::string topic, StageInstance::PrivacyLevel privacyLevel, RequestSettings<BoolResponse> settings) {
@@ -750,11 +750,11 @@ namespace SleepyDiscord {
 		doc.AddMember("topic", rapidjson::Value::StringRefType{ topic.c_str(), topic.length() }, allocator);
 		if (privacyLevel != StageInstance::PrivacyLevel::NotSet)
 			doc.AddMember("privacy_level", static_cast<StageInstance::PrivacyLevelRaw>(privacyLevel), allocator);
-		return BoolResponse{ request(Patch, path("/stage-instances/{channel.id}", {channelID}), settings, json::stringify(doc)) };
+		return BoolResponse{ request(Patch, path(Routes::stageInstance, {channelID}), settings, json::stringify(doc)) };
 	}
 
 	BoolResponse BaseDiscordClient::deleteStageInstance(Snowflake<Channel> channelID, RequestSettings<BoolResponse> settings) {
-		return BoolResponse{ request(Delete, path("/stage-instances/{channel.id}", {channelID}), settings) };
+		return BoolResponse{ request(Delete, path(Routes::stageInstance, {channelID}), settings) };
 	}
 
 	std::string CDN_path(const std::initializer_list<std::string> path) {
@@ -776,10 +776,13 @@ namespace SleepyDiscord {
 	void BaseDiscordClient::getServerBanner(Snowflake<Server> serverID, std::string banner, std::string format, std::function<void(StandardResponse&)> callback) {
 		static constexpr const char* pathMid = "banners/";
 		const std::string path = CDN_path({pathMid, serverID, "/", banner, format});
-		postTask([path, callback]() {
-			Session session;
-			session.setUrl(path);
-			auto response = StandardResponse{session.request(Get)};
+		postTask([this, path, callback]() {
+			const std::string emptyBody;
+			SessionPool::Handle session = sessionPool.acquire(path);
+			session->setUrl(path);
+			session->setBody(&emptyBody);
+			session->setHeader({});
+			auto response = StandardResponse{session->request(Get)};
 			callback(response);
 		});
 	}
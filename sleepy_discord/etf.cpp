@@ -0,0 +1,292 @@
+#include <cstring>
+#include "etf.h"
+
+namespace SleepyDiscord {
+	namespace ETF {
+		namespace {
+			//deeper terms are treated as invalid, so that bad data can't overflow the stack
+			constexpr int maxDepth = 256;
+
+			struct Decoder {
+				const unsigned char* position;
+				const unsigned char* const end;
+				json::Value::AllocatorType& allocator;
+
+				inline bool has(const std::size_t count) const {
+					return count <= static_cast<std::size_t>(end - position);
+				}
+
+				template<class Integer>
+				inline Integer readBigEndian(const std::size_t size = sizeof(Integer)) {
+					Integer result = 0;
+					for (std::size_t i = 0; i < size; ++i)
+						result = static_cast<Integer>((result << 8) | position[i]);
+					position += size;
+					return result;
+				}
+
+				bool readString(json::Value& value, const std::size_t length) {
+					if (!has(length))
+						return false;
+					value.SetString(reinterpret_cast<const char*>(position),
+						static_cast<SizeType>(length), allocator);
+					position += length;
+					return true;
+				}
+
+				bool readAtom(json::Value& value, const std::size_t length) {
+					if (!has(length))
+						return false;
+					const char* name = reinterpret_cast<const char*>(position);
+					if (length == 3 && std::memcmp(name, "nil", 3) == 0)
+						value.SetNull();
+					else if (length == 4 && std::memcmp(name, "true", 4) == 0)
+						value.SetBool(true);
+					else if (length == 5 && std::memcmp(name, "false", 5) == 0)
+						value.SetBool(false);
+					else
+						return readString(value, length);
+					position += length;
+					return true;
+				}
+
+				bool readBig(json::Value& value, const std::size_t byteCount) {
+					//snowflakes fit in 64 bits, anything larger isn't used by Discord
+					if (!has(byteCount + 1) || 8 < byteCount)
+						return false;
+					const bool isNegative = *position++ != 0;
+					uint64_t magnitude = 0;
+					for (std::size_t i = 0; i < byteCount; ++i)
+						magnitude |= static_cast<uint64_t>(position[i]) << (8 * i);
+					position += byteCount;
+
+					char digits[21];
+					char* start = digits + sizeof(digits);
+					do {
+						*--start = static_cast<char>('0' + magnitude % 10);
+						magnitude /= 10;
+					} while (magnitude != 0);
+					if (isNegative)
+						*--start = '-';
+					value.SetString(start, static_cast<SizeType>(digits + sizeof(digits) - start), allocator);
+					return true;
+				}
+
+				bool readArray(json::Value& value, const std::size_t length, const int depth) {
+					//every term is at least one byte, so this stops huge lengths from reserving memory
+					if (!has(length))
+						return false;
+					value.SetArray();
+					value.Reserve(static_cast<SizeType>(length), allocator);
+					for (std::size_t i = 0; i < length; ++i) {
+						json::Value element;
+						if (!read(element, depth + 1))
+							return false;
+						value.PushBack(element, allocator);
+					}
+					return true;
+				}
+
+				bool read(json::Value& value, const int depth) {
+					if (maxDepth < depth || !has(1))
+						return false;
+					switch (*position++) {
+					case SMALL_INTEGER_EXT:
+						if (!has(1)) return false;
+						value.SetInt(*position++);
+						return true;
+					case INTEGER_EXT:
+						if (!has(4)) return false;
+						value.SetInt(static_cast<int32_t>(readBigEndian<uint32_t>()));
+						return true;
+					case NEW_FLOAT_EXT: {
+						if (!has(8)) return false;
+						const uint64_t bits = readBigEndian<uint64_t>();
+						double number;
+						std::memcpy(&number, &bits, sizeof(number));
+						value.SetDouble(number);
+						return true;
+					}
+					case FLOAT_EXT: {
+						//old format, a float printed into 31 bytes
+						constexpr std::size_t size = 31;
+						if (!has(size)) return false;
+						char text[size + 1];
+						std::memcpy(text, position, size);
+						text[size] = '\0';
+						position += size;
+						value.SetDouble(std::strtod(text, nullptr));
+						return true;
+					}
+					case ATOM_EXT:
+					case ATOM_UTF8_EXT:
+						if (!has(2)) return false;
+						return readAtom(value, readBigEndian<uint16_t>());
+					case SMALL_ATOM_EXT:
+					case SMALL_ATOM_UTF8_EXT:
+						if (!has(1)) return false;
+						return readAtom(value, *position++);
+					case BINARY_EXT:
+						if (!has(4)) return false;
+						return readString(value, readBigEndian<uint32_t>());
+					case SMALL_BIG_EXT:
+						if (!has(1)) return false;
+						return readBig(value, *position++);
+					case LARGE_BIG_EXT:
+						if (!has(4)) return false;
+						return readBig(value, readBigEndian<uint32_t>());
+					case SMALL_TUPLE_EXT:
+						if (!has(1)) return false;
+						return readArray(value, *position++, depth);
+					case LARGE_TUPLE_EXT:
+						if (!has(4)) return false;
+						return readArray(value, readBigEndian<uint32_t>(), depth);
+					case NIL_EXT:
+						value.SetArray();
+						return true;
+					case STRING_EXT: {
+						//a list of bytes
+						if (!has(2)) return false;
+						const std::size_t length = readBigEndian<uint16_t>();
+						if (!has(length)) return false;
+						value.SetArray();
+						value.Reserve(static_cast<SizeType>(length), allocator);
+						for (std::size_t i = 0; i < length; ++i)
+							value.PushBack(json::Value(static_cast<int>(*position++)), allocator);
+						return true;
+					}
+					case LIST_EXT: {
+						if (!has(4)) return false;
+						if (!readArray(value, readBigEndian<uint32_t>(), depth))
+							return false;
+						//proper lists end with an empty list, other tails are added as the last element
+						json::Value tail;
+						if (!read(tail, depth + 1))
+							return false;
+						if (!tail.IsArray() || !tail.Empty())
+							value.PushBack(tail, allocator);
+						return true;
+					}
+					case MAP_EXT: {
+						if (!has(4)) return false;
+						const std::size_t arity = readBigEndian<uint32_t>();
+						if (!has(arity)) return false;
+						value.SetObject();
+						value.MemberReserve(static_cast<SizeType>(arity), allocator);
+						for (std::size_t i = 0; i < arity; ++i) {
+							json::Value key;
+							json::Value member;
+							if (!read(key, depth + 1) || !key.IsString() || !read(member, depth + 1))
+								return false;
+							value.AddMember(key, member, allocator);
+						}
+						return true;
+					}
+					default:
+						return false;
+					}
+				}
+			};
+
+			template<class Integer>
+			inline void writeBigEndian(std::string& out, const Integer number) {
+				for (int shift = (sizeof(Integer) - 1) * 8; 0 <= shift; shift -= 8)
+					out += static_cast<char>((number >> shift) & 0xFF);
+			}
+
+			inline void writeAtom(std::string& out, const char* name, const std::size_t length) {
+				out += static_cast<char>(SMALL_ATOM_UTF8_EXT);
+				out += static_cast<char>(length);
+				out.append(name, length);
+			}
+
+			void writeBig(std::string& out, const bool isNegative, uint64_t magnitude) {
+				out += static_cast<char>(SMALL_BIG_EXT);
+				const std::size_t countPosition = out.length();
+				out += '\0';
+				out += static_cast<char>(isNegative ? 1 : 0);
+				char byteCount = 0;
+				for (; magnitude != 0; magnitude >>= 8, ++byteCount)
+					out += static_cast<char>(magnitude & 0xFF);
+				out[countPosition] = byteCount;
+			}
+
+			void write(const json::Value& value, std::string& out) {
+				switch (value.GetType()) {
+				case rapidjson::kNullType:  writeAtom(out, "nil"  , 3); break;
+				case rapidjson::kFalseType: writeAtom(out, "false", 5); break;
+				case rapidjson::kTrueType:  writeAtom(out, "true" , 4); break;
+				case rapidjson::kNumberType:
+					if (value.IsInt()) {
+						const int number = value.GetInt();
+						if (0 <= number && number <= 255) {
+							out += static_cast<char>(SMALL_INTEGER_EXT);
+							out += static_cast<char>(number);
+						} else {
+							out += static_cast<char>(INTEGER_EXT);
+							writeBigEndian(out, static_cast<uint32_t>(number));
+						}
+					} else if (value.IsUint64()) {
+						writeBig(out, false, value.GetUint64());
+					} else if (value.IsInt64()) {
+						const int64_t number = value.GetInt64();
+						writeBig(out, true, static_cast<uint64_t>(-(number + 1)) + 1);
+					} else {
+						out += static_cast<char>(NEW_FLOAT_EXT);
+						const double number = value.GetDouble();
+						uint64_t bits;
+						std::memcpy(&bits, &number, sizeof(bits));
+						writeBigEndian(out, bits);
+					}
+					break;
+				case rapidjson::kStringType:
+					out += static_cast<char>(BINARY_EXT);
+					writeBigEndian(out, static_cast<uint32_t>(value.GetStringLength()));
+					out.append(value.GetString(), value.GetStringLength());
+					break;
+				case rapidjson::kArrayType:
+					if (!value.Empty()) {
+						out += static_cast<char>(LIST_EXT);
+						writeBigEndian(out, static_cast<uint32_t>(value.Size()));
+						for (const json::Value& element : value.GetArray())
+							write(element, out);
+					}
+					out += static_cast<char>(NIL_EXT);
+					break;
+				case rapidjson::kObjectType:
+					out += static_cast<char>(MAP_EXT);
+					writeBigEndian(out, static_cast<uint32_t>(value.MemberCount()));
+					for (const auto& member : value.GetObject()) {
+						write(member.name, out);
+						write(member.value, out);
+					}
+					break;
+				}
+			}
+		}
+
+		bool decode(const char* data, const std::size_t length,
+			json::Value& value, json::Value::AllocatorType& allocator
+		) {
+			const unsigned char* start = reinterpret_cast<const unsigned char*>(data);
+			Decoder decoder{ start, start + length, allocator };
+			if (!decoder.has(1) || *decoder.position++ != VERSION)
+				return false;
+			return decoder.read(value, 0);
+		}
+
+		void encode(const json::Value& value, std::string& out) {
+			out += static_cast<char>(VERSION);
+			write(value, out);
+		}
+
+		bool encodeJSON(const std::string& json, std::string& out) {
+			rapidjson::Document document;
+			document.Parse(json.c_str(), json.length());
+			if (document.HasParseError())
+				return false;
+			encode(document, out);
+			return true;
+		}
+	}
+}
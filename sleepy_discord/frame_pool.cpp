@@ -0,0 +1,115 @@
+#include <algorithm>
+#include "frame_pool.h"
+
+namespace SleepyDiscord {
+	Frame::Frame(std::size_t valueCapacity, std::size_t stackCapacity) {
+		build(valueCapacity, stackCapacity);
+	}
+
+	void Frame::build(std::size_t newValueCapacity, std::size_t newStackCapacity) {
+		//the document uses the allocators, so it needs to go first
+		document.reset();
+		valueAllocator.reset();
+		stackAllocator.reset();
+
+		if (valueCapacity != newValueCapacity) {
+			valueBuffer.reset(new char[newValueCapacity]);
+			valueCapacity = newValueCapacity;
+		}
+		if (stackCapacity != newStackCapacity) {
+			stackBuffer.reset(new char[newStackCapacity]);
+			stackCapacity = newStackCapacity;
+		}
+		valueAllocator.reset(new Allocator(valueBuffer.get(), valueCapacity));
+		stackAllocator.reset(new Allocator(stackBuffer.get(), stackCapacity));
+		document.reset(new Document(valueAllocator.get(), stackCapacity / 2, stackAllocator.get()));
+	}
+
+	void Frame::recycle(std::size_t maxCapacity) {
+		//an allocator with more capacity than its buffer ran out of space and allocated chunks,
+		//so give it a buffer that fits everything so that the next message like that doesn't
+		const std::size_t headerSize = 64; //room for the chunk header
+		const auto neededCapacity = [maxCapacity, headerSize](const Allocator& allocator, const std::size_t capacity) {
+			return capacity < allocator.Capacity() ?
+				std::max(capacity, std::min(allocator.Capacity() + headerSize, maxCapacity)) : capacity;
+		};
+		const std::size_t newValueCapacity = neededCapacity(*valueAllocator, valueCapacity);
+		const std::size_t newStackCapacity = neededCapacity(*stackAllocator, stackCapacity);
+		if (newValueCapacity != valueCapacity || newStackCapacity != stackCapacity) {
+			build(newValueCapacity, newStackCapacity);
+		} else {
+			//the allocators don't free anything, so the document only needs to forget its values
+			document->SetNull();
+			valueAllocator->Clear();
+			stackAllocator->Clear();
+		}
+
+		event.reset();
+		if (maxCapacity < text.capacity())
+			std::string().swap(text);
+		else
+			text.clear();
+	}
+
+	FramePool::Lease FramePool::acquire() {
+		std::lock_guard<std::mutex> lock(state->mutex);
+		if (state->idleFrames.empty()) {
+			constexpr std::size_t defaultValueCapacity = 16 * 1024;
+			constexpr std::size_t defaultStackCapacity = 4 * 1024;
+			state->frames.emplace_back(new Frame(defaultValueCapacity, defaultStackCapacity));
+			state->idleFrames.reserve(state->frames.size());
+			return adopt(state->frames.back().get());
+		}
+		Frame* frame = state->idleFrames.back();
+		state->idleFrames.pop_back();
+		return adopt(frame);
+	}
+
+	std::shared_ptr<Frame> FramePool::share(Lease lease) {
+		Frame* frame = lease.release();
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			auto found = std::find_if(state->frames.begin(), state->frames.end(),
+				[frame](const std::unique_ptr<Frame>& owned) { return owned.get() == frame; });
+			if (found != state->frames.end()) {
+				found->release();
+				state->frames.erase(found);
+			}
+		}
+		const std::weak_ptr<State> weakState = state;
+		return std::shared_ptr<Frame>(frame, [weakState](Frame* frame) {
+			const std::shared_ptr<State> state = weakState.lock();
+			if (!state) {
+				delete frame;
+				return;
+			}
+			{
+				std::lock_guard<std::mutex> lock(state->mutex);
+				state->frames.emplace_back(frame);
+			}
+			release(*state, frame);
+		});
+	}
+
+	void FramePool::release(State& state, Frame* frame) {
+		//destroy frames that are over the limit outside of the lock
+		std::unique_ptr<Frame> overflow;
+		std::lock_guard<std::mutex> lock(state.mutex);
+		if (state.idleFrames.size() < state.settings.maxIdleFrames) {
+			frame->recycle(state.settings.maxFrameCapacity);
+			state.idleFrames.push_back(frame);
+			return;
+		}
+		auto found = std::find_if(state.frames.begin(), state.frames.end(),
+			[frame](const std::unique_ptr<Frame>& owned) { return owned.get() == frame; });
+		if (found != state.frames.end()) {
+			overflow = std::move(*found);
+			state.frames.erase(found);
+		}
+	}
+
+	std::size_t FramePool::size() {
+		std::lock_guard<std::mutex> lock(state->mutex);
+		return state->idleFrames.size();
+	}
+}
@@ -7,6 +7,9 @@ namespace SleepyDiscord {
 	Gateway::Gateway(const json::Value& json) :
 		Gateway(json::fromJSON<Gateway>(json)) {
 	}
+	GatewaySession::GatewaySession(const json::Value& json) :
+		GatewaySession(json::fromJSON<GatewaySession>(json)) {
+	}
 	Ready::Ready(const json::Value & json) :
 		Ready(json::fromJSON<Ready>(json)) {
 	}
@@ -0,0 +1,51 @@
+#include "io_thread_pool.h"
+#ifndef NONEXISTENT_ASIO
+#include <thread>
+#include <vector>
+#if defined(_WIN32)
+	#include <windows.h>
+#elif defined(__linux__)
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+namespace SleepyDiscord {
+	void IOThreadPool::run(asio::io_service& io) {
+		const Settings current = getSettings();
+		const std::size_t threadCount = current.threadCount < 1 ? 1 : current.threadCount;
+		const auto runThread = [&io, current](std::size_t index) {
+			if (current.pinThreads)
+				pinThread(current.firstCPU + index);
+			io.run();
+		};
+
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount - 1);
+		for (std::size_t index = 1; index < threadCount; ++index)
+			threads.emplace_back(runThread, index);
+		runThread(0);
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+	bool IOThreadPool::pinThread(std::size_t cpu) {
+		const unsigned int cpuCount = std::thread::hardware_concurrency();
+		if (cpuCount != 0)
+			cpu %= cpuCount;
+#if defined(_WIN32)
+		if (sizeof(DWORD_PTR) * 8 <= cpu)
+			return false;
+		return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+#elif defined(__linux__)
+		if (CPU_SETSIZE <= cpu)
+			return false;
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		CPU_SET(cpu, &cpus);
+		return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+		return false;
+#endif
+	}
+}
+#endif
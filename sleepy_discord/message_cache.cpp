@@ -0,0 +1,177 @@
+#include <algorithm>
+#include "message_cache.h"
+
+namespace SleepyDiscord {
+	MessageCache::MessageCache(Settings _settings) : settings(_settings) {
+		if (settings.messagesPerChannel < 1)
+			settings.messagesPerChannel = 1;
+	}
+
+	const MessageCache::Slot* MessageCache::Ring::find(const Key& messageID) const {
+		//edits and deletes are usually for recent messages, so start from the newest
+		for (std::size_t i = slots.size(); 0 < i; --i) {
+			const Slot& slot = slots[(oldest() + i - 1) % slots.size()];
+			if (slot.isUsed && slot.message.ID.raw() == messageID)
+				return &slot;
+		}
+		return nullptr;
+	}
+
+	MessageCache::Ring* MessageCache::findRing(const Key& channelID) {
+		auto found = channels.find(channelID);
+		return found != channels.end() ? &found->second : nullptr;
+	}
+
+	void MessageCache::removeSlot(Ring& ring, Slot& slot) {
+		slot.isUsed = false;
+		slot.message = Message();
+		--ring.used;
+		--total;
+	}
+
+	void MessageCache::removeRing(std::unordered_map<Key, Ring>::iterator ring) {
+		total -= ring->second.used;
+		activity.erase(ring->second.activity);
+		channels.erase(ring);
+	}
+
+	void MessageCache::evictOldest() {
+		auto ring = channels.find(activity.back());
+		Ring& channel = ring->second;
+		for (std::size_t i = 0; i < channel.slots.size(); ++i) {
+			Slot& slot = channel.slots[(channel.oldest() + i) % channel.slots.size()];
+			if (slot.isUsed) {
+				removeSlot(channel, slot);
+				break;
+			}
+		}
+		if (channel.used == 0)
+			removeRing(ring);
+	}
+
+	void MessageCache::add(const Message& message) {
+		std::lock_guard<std::mutex> lock(mutex);
+		const Key& channelID = message.channelID.raw();
+		Ring* ring = findRing(channelID);
+		if (ring == nullptr) {
+			activity.push_front(channelID);
+			ring = &channels[channelID];
+			ring->activity = activity.begin();
+			ring->serverID = message.serverID;
+		} else {
+			activity.splice(activity.begin(), activity, ring->activity);
+			if (Slot* found = ring->find(message.ID.raw())) {
+				found->message = message;
+				return;
+			}
+		}
+
+		if (ring->slots.size() < settings.messagesPerChannel) {
+			ring->slots.push_back(Slot{ message, true });
+			ring->next = ring->slots.size() % settings.messagesPerChannel;
+		} else {
+			Slot& slot = ring->slots[ring->next];
+			if (slot.isUsed)
+				removeSlot(*ring, slot);
+			slot.message = message;
+			slot.isUsed = true;
+			ring->next = (ring->next + 1) % settings.messagesPerChannel;
+		}
+		++ring->used;
+		++total;
+
+		while (settings.maxMessages < total)
+			evictOldest();
+	}
+
+	bool MessageCache::update(MessageRevisions& revisions, Message* before, Message* after) {
+		std::lock_guard<std::mutex> lock(mutex);
+		Ring* ring = findRing(revisions.channelID.raw());
+		Slot* slot = ring != nullptr ? ring->find(revisions.messageID.raw()) : nullptr;
+		if (slot == nullptr)
+			return false;
+		if (before != nullptr)
+			*before = slot->message;
+		revisions.applyChanges(slot->message);
+		if (after != nullptr)
+			*after = slot->message;
+		return true;
+	}
+
+	tl::optional<Message> MessageCache::erase(
+		const Snowflake<Channel>& channelID, const Snowflake<Message>& messageID
+	) {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto ring = channels.find(channelID.raw());
+		if (ring == channels.end())
+			return tl::nullopt;
+		Slot* slot = ring->second.find(messageID.raw());
+		if (slot == nullptr)
+			return tl::nullopt;
+		tl::optional<Message> erased(std::move(slot->message));
+		removeSlot(ring->second, *slot);
+		if (ring->second.used == 0)
+			removeRing(ring);
+		return erased;
+	}
+
+	void MessageCache::eraseChannel(const Snowflake<Channel>& channelID) {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto ring = channels.find(channelID.raw());
+		if (ring != channels.end())
+			removeRing(ring);
+	}
+
+	void MessageCache::eraseServer(const Snowflake<Server>& serverID) {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto ring = channels.begin(); ring != channels.end();) {
+			auto next = std::next(ring);
+			if (ring->second.serverID == serverID)
+				removeRing(ring);
+			ring = next;
+		}
+	}
+
+	void MessageCache::clear() {
+		std::lock_guard<std::mutex> lock(mutex);
+		channels.clear();
+		activity.clear();
+		total = 0;
+	}
+
+	tl::optional<Message> MessageCache::find(
+		const Snowflake<Channel>& channelID, const Snowflake<Message>& messageID
+	) const {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto ring = channels.find(channelID.raw());
+		if (ring == channels.end())
+			return tl::nullopt;
+		const Slot* slot = ring->second.find(messageID.raw());
+		if (slot == nullptr)
+			return tl::nullopt;
+		return slot->message;
+	}
+
+	std::vector<Message> MessageCache::getRecent(const Snowflake<Channel>& channelID, std::size_t limit) const {
+		std::vector<Message> messages;
+		std::lock_guard<std::mutex> lock(mutex);
+		auto ring = channels.find(channelID.raw());
+		if (ring == channels.end())
+			return messages;
+		const Ring& channel = ring->second;
+		if (limit == 0 || channel.used < limit)
+			limit = channel.used;
+		messages.reserve(limit);
+		for (std::size_t i = channel.slots.size(); 0 < i && messages.size() < limit; --i) {
+			const Slot& slot = channel.slots[(channel.oldest() + i - 1) % channel.slots.size()];
+			if (slot.isUsed)
+				messages.push_back(slot.message);
+		}
+		return messages;
+	}
+
+	std::size_t MessageCache::size() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return total;
+	}
+}
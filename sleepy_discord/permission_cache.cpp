@@ -0,0 +1,115 @@
+#include "permission_cache.h"
+
+namespace SleepyDiscord {
+	PermissionCache::ChannelMasks::ChannelMasks(const Server& server, const Channel& channel) :
+		serverID(server.ID.raw())
+	{
+		//like findObject, the first overwrite for an id is the one used
+		bool hasEveryone = false;
+		overwrites.reserve(channel.permissionOverwrites.size());
+		for (const Overwrite& overwrite : channel.permissionOverwrites) {
+			const Masks masks{ overwrite.allow, overwrite.deny };
+			if (overwrite.ID.raw() != serverID) {
+				overwrites.emplace(overwrite.ID.raw(), masks);
+			} else if (!hasEveryone) {
+				everyone = masks;
+				hasEveryone = true;
+			}
+		}
+	}
+
+	Permission PermissionCache::getBasePermissions(const Server& server, const ServerMember& member) {
+		uint64_t generation;
+		{
+			ReadLock lock(mutex);
+			auto foundServer = basePermissions.find(server.ID.raw());
+			if (foundServer != basePermissions.end()) {
+				auto found = foundServer->second.find(member.user.ID.raw());
+				if (found != foundServer->second.end())
+					return found->second;
+			}
+			generation = getGeneration(server.ID.raw());
+		}
+		const Permission permissions = SleepyDiscord::getBasePermissions(server, member);
+		WriteLock lock(mutex);
+		//the server was invalidated while working them out, so they may be out of date
+		if (getGeneration(server.ID.raw()) != generation)
+			return permissions;
+		basePermissions[server.ID.raw()][member.user.ID.raw()] = permissions;
+		return permissions;
+	}
+
+	Permission PermissionCache::ChannelMasks::apply(Permission permissions, const ServerMember& member) const {
+		handleOverwrite(permissions, everyone.allow, everyone.deny);
+		Masks roles;
+		for (const Snowflake<Role>& roleID : member.roles) {
+			if (const Masks* role = find(roleID.raw())) {
+				roles.allow = roles.allow | role->allow;
+				roles.deny = roles.deny | role->deny;
+			}
+		}
+		handleOverwrite(permissions, roles.allow, roles.deny);
+		if (const Masks* memberMasks = find(member.user.ID.raw()))
+			handleOverwrite(permissions, memberMasks->allow, memberMasks->deny);
+		return permissions;
+	}
+
+	Permission PermissionCache::getPermissions(const Server& server, const ServerMember& member, const Channel& channel) {
+		const Permission permissions = getBasePermissions(server, member);
+		if (hasPremission(permissions, Permission::ADMINISTRATOR))
+			return Permission::ALL;
+		{
+			ReadLock lock(mutex);
+			auto found = channels.find(channel.ID.raw());
+			if (found != channels.end())
+				return found->second.apply(permissions, member);
+		}
+		WriteLock lock(mutex);
+		auto found = channels.find(channel.ID.raw());
+		if (found == channels.end())
+			found = channels.emplace(channel.ID.raw(), ChannelMasks(server, channel)).first;
+		return found->second.apply(permissions, member);
+	}
+
+	void PermissionCache::invalidateServer(const Snowflake<Server>& serverID) {
+		WriteLock lock(mutex);
+		basePermissions.erase(serverID.raw());
+		++generations[serverID.raw()];
+	}
+
+	void PermissionCache::invalidateMember(const Snowflake<Server>& serverID, const Snowflake<User>& userID) {
+		WriteLock lock(mutex);
+		++generations[serverID.raw()];
+		auto found = basePermissions.find(serverID.raw());
+		if (found == basePermissions.end())
+			return;
+		found->second.erase(userID.raw());
+		if (found->second.empty())
+			basePermissions.erase(found);
+	}
+
+	void PermissionCache::invalidateChannel(const Snowflake<Channel>& channelID) {
+		WriteLock lock(mutex);
+		channels.erase(channelID.raw());
+	}
+
+	void PermissionCache::eraseServer(const Snowflake<Server>& serverID) {
+		WriteLock lock(mutex);
+		basePermissions.erase(serverID.raw());
+		++generations[serverID.raw()];
+		for (auto channel = channels.begin(); channel != channels.end();) {
+			if (channel->second.serverID == serverID.raw())
+				channel = channels.erase(channel);
+			else
+				++channel;
+		}
+	}
+
+	void PermissionCache::clear() {
+		WriteLock lock(mutex);
+		basePermissions.clear();
+		channels.clear();
+		//so that permissions worked out before this aren't stored
+		++clearCount;
+	}
+}
@@ -1,3 +1,4 @@
+#include <unordered_map>
 #include "permissions.h"
 #include "server.h"
 #include "channel.h"
@@ -69,6 +70,117 @@ namespace SleepyDiscord {
 		return overwritePermissions(getBasePermissions(server, member), server, member, channel);
 	}
 
+	ChannelPermissions::ChannelPermissions(const Server& server, const Channel& channel) {
+		//the first overwrite for an id is used, like in overwritePermissions
+		std::unordered_map<SnowflakeRaw::Type, const Overwrite*> overwrites;
+		overwrites.reserve(channel.permissionOverwrites.size());
+		for (const Overwrite& overwrite : channel.permissionOverwrites)
+			overwrites.emplace(overwrite.ID.raw(), &overwrite);
+		auto findOverwrite = [&overwrites](const SnowflakeRaw::Type& ID) -> const Overwrite* {
+			auto found = overwrites.find(ID);
+			return found != overwrites.end() ? found->second : nullptr;
+		};
+
+		if (const Overwrite* everyone = findOverwrite(server.ID.raw())) {
+			everyoneAllow = everyone->allow;
+			everyoneDeny = everyone->deny;
+		}
+
+		//without the everyone role, members other than the owner have no base permissions
+		auto everyoneRole = server.roles.find(server.ID.raw());
+		const bool hasEveryoneRole = everyoneRole != server.roles.end();
+		if (hasEveryoneRole)
+			everyonePermissions = everyoneRole->permissions;
+
+		//roles get an index the first time a member has them, overwrites are used even for
+		//roles that aren't in the server, like in overwritePermissions
+		std::unordered_map<SnowflakeRaw::Type, uint32_t> roleIndexes;
+		roleIndexes.reserve(server.roles.size());
+		auto getRoleIndex = [&](const Snowflake<Role>& roleID) {
+			auto found = roleIndexes.find(roleID.raw());
+			if (found != roleIndexes.end())
+				return found->second;
+			const uint32_t index = static_cast<uint32_t>(rolePermissions.size());
+			roleIndexes.emplace(roleID.raw(), index);
+			auto role = hasEveryoneRole ? server.roles.find(roleID.raw()) : server.roles.end();
+			rolePermissions.push_back(role != server.roles.end() ? role->permissions : NONE);
+			const Overwrite* overwrite = findOverwrite(roleID.raw());
+			roleAllow.push_back(overwrite != nullptr ? overwrite->allow : NONE);
+			roleDeny.push_back(overwrite != nullptr ? overwrite->deny : NONE);
+			return index;
+		};
+
+		const std::size_t memberCount = server.members.size();
+		memberIDs.reserve(memberCount);
+		roleOffsets.reserve(memberCount + 1);
+		memberAllow.reserve(memberCount);
+		memberDeny.reserve(memberCount);
+		isOwner.reserve(memberCount);
+		roleOffsets.push_back(0);
+		for (const ServerMember& member : server.members) {
+			memberIDs.push_back(member.user.ID);
+			for (const Snowflake<Role>& roleID : member.roles)
+				memberRoles.push_back(getRoleIndex(roleID));
+			roleOffsets.push_back(static_cast<uint32_t>(memberRoles.size()));
+			const Overwrite* overwrite = findOverwrite(member.user.ID.raw());
+			memberAllow.push_back(overwrite != nullptr ? overwrite->allow : NONE);
+			memberDeny.push_back(overwrite != nullptr ? overwrite->deny : NONE);
+			isOwner.push_back(server.ownerID == member.user.ID ? ~PermissionRaw(0) : 0);
+		}
+	}
+
+	template<class Output>
+	void ChannelPermissions::evaluate(Output output) const {
+		const PermissionRaw administrator = ADMINISTRATOR;
+		const std::size_t memberCount = memberIDs.size();
+		for (std::size_t i = 0; i < memberCount; ++i) {
+			PermissionRaw base = everyonePermissions;
+			PermissionRaw allow = 0;
+			PermissionRaw deny = 0;
+			for (uint32_t role = roleOffsets[i]; role < roleOffsets[i + 1]; ++role) {
+				const uint32_t index = memberRoles[role];
+				base |= rolePermissions[index];
+				allow |= roleAllow[index];
+				deny |= roleDeny[index];
+			}
+			PermissionRaw permissions = (base & ~everyoneDeny) | everyoneAllow;
+			permissions = (permissions & ~deny) | allow;
+			permissions = (permissions & ~memberDeny[i]) | memberAllow[i];
+			//owners and administrators get everything, done with a mask instead of a branch
+			const PermissionRaw isAdministrator = ~((base & administrator) / administrator - 1);
+			const PermissionRaw all = (isAdministrator | isOwner[i]) & ALL;
+			output(i, static_cast<Permission>((permissions & ~(isAdministrator | isOwner[i])) | all));
+		}
+	}
+
+	std::vector<Permission> ChannelPermissions::getPermissions() const {
+		std::vector<Permission> permissions(memberIDs.size(), NONE);
+		evaluate([&permissions](const std::size_t i, const Permission permission) {
+			permissions[i] = permission;
+		});
+		return permissions;
+	}
+
+	std::vector<uint64_t> ChannelPermissions::getBitmap(const Permission permission) const {
+		std::vector<uint64_t> bitmap((memberIDs.size() + 63) / 64, 0);
+		const PermissionRaw mask = permission;
+		evaluate([&bitmap, mask](const std::size_t i, const Permission result) {
+			const uint64_t has = (static_cast<PermissionRaw>(result) & mask) == mask;
+			bitmap[i / 64] |= has << (i % 64);
+		});
+		return bitmap;
+	}
+
+	std::vector<Snowflake<User>> ChannelPermissions::getMembersWith(const Permission permission) const {
+		std::vector<Snowflake<User>> members;
+		const PermissionRaw mask = permission;
+		evaluate([this, &members, mask](const std::size_t i, const Permission result) {
+			if ((static_cast<PermissionRaw>(result) & mask) == mask)
+				members.push_back(memberIDs[i]);
+		});
+		return members;
+	}
+
 	Role::Role(const json::Value & json) :
 		Role(json::fromJSON<Role>(json)) {
 	}
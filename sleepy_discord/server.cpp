@@ -1,23 +1,364 @@
 #include "server.h"
 #include "client.h"
 #include "permissions.h"
+#include <algorithm>
 
 namespace SleepyDiscord {
-	std::list<ServerMember>::iterator Server::findMember(Snowflake<User> userID) {
-		return userID.findObject(members.begin(), members.end());
+	Cache<ServerMember>::iterator Server::findMember(Snowflake<User> userID) {
+		return members.find(userID.raw());
 	}
 
-	std::list<Channel>::iterator Server::findChannel(Snowflake<Channel> channelID) {
-		return channelID.findObject(channels.begin(), channels.end());
+	Cache<Channel>::iterator Server::findChannel(Snowflake<Channel> channelID) {
+		return channels.find(channelID.raw());
 	}
 
-	std::list<Role>::iterator Server::findRole(Snowflake<Role> roleID) {
-		return roleID.findObject(roles.begin(), roles.end());
+	Cache<Role>::iterator Server::findRole(Snowflake<Role> roleID) {
+		return roles.find(roleID.raw());
+	}
+
+	const ServerCache::Kind<ServerMember> ServerCache::memberKind = {
+		&Server::members, &Policies::members, &Counters::members, &Trackers::members };
+	const ServerCache::Kind<Channel> ServerCache::channelKind = {
+		&Server::channels, &Policies::channels, &Counters::channels, &Trackers::channels };
+	const ServerCache::Kind<Role> ServerCache::roleKind = {
+		&Server::roles, &Policies::roles, &Counters::roles, &Trackers::roles };
+
+	std::pair<ServerCache::iterator, bool> ServerCache::insert(const Server& server) {
+		WriteLock serversLock(locks.servers);
+		WriteLock indexesLock(locks.indexes);
+		const Key& serverID = server.ID.raw();
+		iterator found = find(serverID);
+		if (found == end()) {
+			std::pair<iterator, bool> result = Cache<Server>::insert(server);
+			applyPolicies(*result.first);
+			index(serverID, *result.first);
+			return result;
+		}
+		unindex(serverID, *found);
+		*found = server;
+		applyPolicies(*found);
+		index(serverID, *found);
+		return { found, false };
+	}
+
+	ServerCache::iterator ServerCache::erase(const_iterator pos) {
+		WriteLock serversLock(locks.servers);
+		WriteLock indexesLock(locks.indexes);
+		unindex(pos->ID.raw(), *pos);
+		trackers.erase(pos->ID.raw());
+		return Cache<Server>::erase(pos);
+	}
+
+	bool ServerCache::erase(const Snowflake<Server>& serverID) {
+		WriteLock serversLock(locks.servers);
+		iterator found = find(serverID.raw());
+		if (found == end())
+			return false;
+		WriteLock indexesLock(locks.indexes);
+		unindex(serverID.raw(), *found);
+		trackers.erase(serverID.raw());
+		Cache<Server>::erase(found);
+		return true;
+	}
+
+	std::vector<Snowflake<Server>> ServerCache::getServerIDsWith(const Snowflake<User>& userID) const {
+		std::vector<Snowflake<Server>> serverIDs;
+		ReadLock indexesLock(locks.indexes);
+		auto found = memberServers.find(userID.raw());
+		if (found == memberServers.end())
+			return serverIDs;
+		serverIDs.reserve(found->second.size());
+		for (const Key& serverID : found->second)
+			serverIDs.push_back(Snowflake<Server>::fromRaw(serverID));
+		return serverIDs;
+	}
+
+	const ServerCache::ServerIDs& ServerCache::findServersWith(const Snowflake<User>& userID) const {
+		static const ServerIDs none;
+		ReadLock indexesLock(locks.indexes);
+		auto found = memberServers.find(userID.raw());
+		return found != memberServers.end() ? found->second : none;
+	}
+
+	ServerCache::Trackers* ServerCache::findTrackers(const Key& serverID) {
+		auto found = trackers.find(serverID);
+		return found != trackers.end() ? &found->second : nullptr;
+	}
+
+	template<class Object>
+	void ServerCache::trim(Server& server, const Kind<Object>& kind, CacheTracker& tracker) {
+		using ID = typename Kind<Object>::ID;
+		Cache<Object>& container = server.*kind.container;
+		CacheCounters& counter = counters.*kind.counters;
+		const Key& serverID = server.ID.raw();
+		tracker.trim(policies.*kind.policy, CacheTracker::Clock::now(),
+			[&](const Key& key, const bool isExpired) {
+				container.erase(key);
+				unindexObject(serverID, ID::fromRaw(key));
+				++(isExpired ? counter.expired : counter.evicted);
+			}
+		);
+	}
+
+	template<class Object>
+	void ServerCache::cacheObject(Server& server, const Kind<Object>& kind, const Object& object) {
+		const CachePolicy& policy = policies.*kind.policy;
+		CacheCounters& counter = counters.*kind.counters;
+		if (policy.mode == CachePolicy::None) {
+			++counter.skipped;
+			return;
+		}
+		Cache<Object>& container = server.*kind.container;
+		const Key key = object.ID.raw();
+		auto found = container.find(key);
+		if (found == container.end()) {
+			container.insert(object);
+			++counter.added;
+		} else {
+			*found = object;
+		}
+		WriteLock indexesLock(locks.indexes);
+		indexObject(server.ID.raw(), object);
+		Trackers* serverTrackers = policy.isTracked() ? findTrackers(server.ID.raw()) : nullptr;
+		if (serverTrackers == nullptr)
+			return;
+		CacheTracker& tracker = serverTrackers->*kind.tracker;
+		tracker.use(key, CacheTracker::Clock::now());
+		trim(server, kind, tracker);
+	}
+
+	template<class Object>
+	void ServerCache::uncacheObject(Server& server, const Kind<Object>& kind, const typename Kind<Object>::ID& ID) {
+		if ((server.*kind.container).erase(ID.raw()) == 0)
+			return;
+		++(counters.*kind.counters).removed;
+		WriteLock indexesLock(locks.indexes);
+		unindexObject(server.ID.raw(), ID);
+		if (Trackers* serverTrackers = findTrackers(server.ID.raw()))
+			(serverTrackers->*kind.tracker).erase(ID.raw());
+	}
+
+	template<class Object>
+	void ServerCache::useObject(Server& server, const Kind<Object>& kind, const typename Kind<Object>::ID& ID) {
+		if (!(policies.*kind.policy).isTracked())
+			return;
+		Cache<Object>& container = server.*kind.container;
+		Trackers* serverTrackers = findTrackers(server.ID.raw());
+		if (serverTrackers == nullptr || container.find(ID.raw()) == container.end())
+			return;
+		CacheTracker& tracker = serverTrackers->*kind.tracker;
+		tracker.use(ID.raw(), CacheTracker::Clock::now());
+		WriteLock indexesLock(locks.indexes);
+		trim(server, kind, tracker);
+	}
+
+	template<class Object>
+	void ServerCache::applyPolicy(Server& server, const Kind<Object>& kind, Trackers& serverTrackers) {
+		const CachePolicy& policy = policies.*kind.policy;
+		CacheCounters& counter = counters.*kind.counters;
+		Cache<Object>& container = server.*kind.container;
+		CacheTracker& tracker = serverTrackers.*kind.tracker;
+		tracker.clear();
+		if (policy.mode == CachePolicy::None) {
+			counter.skipped += container.size();
+			container.clear();
+			return;
+		}
+		counter.added += container.size();
+		if (!policy.isTracked())
+			return;
+		const CacheTracker::Clock::time_point now = CacheTracker::Clock::now();
+		for (const Object& object : container)
+			tracker.use(object.ID.raw(), now);
+		trim(server, kind, tracker);
+	}
+
+	void ServerCache::applyPolicies(Server& server) {
+		Trackers& serverTrackers = trackers[server.ID.raw()];
+		applyPolicy(server, memberKind, serverTrackers);
+		applyPolicy(server, channelKind, serverTrackers);
+		applyPolicy(server, roleKind, serverTrackers);
+	}
+
+	void ServerCache::cacheObject(Server& server, const ServerMember& member) {
+		cacheObject(server, memberKind, member);
+	}
+
+	void ServerCache::cacheObject(Server& server, const Channel& channel) {
+		cacheObject(server, channelKind, channel);
+	}
+
+	void ServerCache::cacheObject(Server& server, const Role& role) {
+		cacheObject(server, roleKind, role);
+	}
+
+	void ServerCache::uncacheObject(Server& server, const Snowflake<User>& userID) {
+		uncacheObject(server, memberKind, userID);
+	}
+
+	void ServerCache::uncacheObject(Server& server, const Snowflake<Channel>& channelID) {
+		uncacheObject(server, channelKind, channelID);
+	}
+
+	void ServerCache::uncacheObject(Server& server, const Snowflake<Role>& roleID) {
+		uncacheObject(server, roleKind, roleID);
+	}
+
+	void ServerCache::useObject(Server& server, const Snowflake<User>& userID) {
+		useObject(server, memberKind, userID);
+	}
+
+	void ServerCache::useObject(Server& server, const Snowflake<Channel>& channelID) {
+		useObject(server, channelKind, channelID);
+	}
+
+	void ServerCache::useObject(Server& server, const Snowflake<Role>& roleID) {
+		useObject(server, roleKind, roleID);
+	}
+
+	void ServerCache::expire() {
+		ReadLock serversLock(locks.servers);
+		for (auto found = Parent::begin(); found != Parent::end(); ++found) {
+			WriteLock serverLock(getStripe(found->first));
+			Trackers* serverTrackers = findTrackers(found->first);
+			if (serverTrackers == nullptr)
+				continue;
+			WriteLock indexesLock(locks.indexes);
+			trim(found->second, memberKind , serverTrackers->members );
+			trim(found->second, channelKind, serverTrackers->channels);
+			trim(found->second, roleKind   , serverTrackers->roles   );
+		}
+	}
+
+	time_t ServerCache::getExpireInterval() const {
+		time_t interval = 0;
+		for (const CachePolicy* policy : { &policies.members, &policies.channels, &policies.roles })
+			if (policy->mode == CachePolicy::TTL && (interval == 0 || policy->maxAge < interval))
+				interval = policy->maxAge;
+		//objects are then kept at most one and a half times their TTL
+		constexpr time_t minimumInterval = 1000;
+		return interval == 0 ? 0 : (std::max)(interval / 2, minimumInterval);
+	}
+
+	void ServerCache::addToIndex(const Key& serverID, const Channel& channel) {
+		WriteLock indexesLock(locks.indexes);
+		indexObject(serverID, channel);
+	}
+
+	void ServerCache::addToIndex(const Key& serverID, const Role& role) {
+		WriteLock indexesLock(locks.indexes);
+		indexObject(serverID, role);
+	}
+
+	void ServerCache::addToIndex(const Key& serverID, const ServerMember& member) {
+		WriteLock indexesLock(locks.indexes);
+		indexObject(serverID, member);
+	}
+
+	void ServerCache::addToIndexes(const Server& server) {
+		WriteLock indexesLock(locks.indexes);
+		index(server.ID.raw(), server);
+	}
+
+	void ServerCache::indexObject(const Key& serverID, const Channel& channel) {
+		channelServers[channel.ID.raw()] = serverID;
+	}
+
+	void ServerCache::indexObject(const Key& serverID, const Role& role) {
+		roleServers[role.ID.raw()] = serverID;
+	}
+
+	void ServerCache::indexObject(const Key& serverID, const ServerMember& member) {
+		memberServers[member.ID.raw()].insert(serverID);
+	}
+
+	void ServerCache::index(const Key& serverID, const Server& server) {
+		for (const Channel& channel : server.channels)
+			indexObject(serverID, channel);
+		for (const Role& role : server.roles)
+			indexObject(serverID, role);
+		for (const ServerMember& member : server.members)
+			indexObject(serverID, member);
+	}
+
+	namespace {
+		template<class Object>
+		void removeFromIndex(std::unordered_map<ServerCache::Key, ServerCache::Key>& index,
+			const ServerCache::Key& serverID, const Snowflake<Object>& objectID
+		) {
+			auto found = index.find(objectID.raw());
+			if (found != index.end() && found->second == serverID)
+				index.erase(found);
+		}
+
+		void removeFromIndex(std::unordered_map<ServerCache::Key, ServerCache::ServerIDs>& index,
+			const ServerCache::Key& serverID, const Snowflake<User>& userID
+		) {
+			auto found = index.find(userID.raw());
+			if (found == index.end())
+				return;
+			found->second.erase(serverID);
+			if (found->second.empty())
+				index.erase(found);
+		}
+	}
+
+	void ServerCache::removeFromIndex(const Key& serverID, const Snowflake<Channel>& channelID) {
+		WriteLock indexesLock(locks.indexes);
+		unindexObject(serverID, channelID);
+	}
+
+	void ServerCache::removeFromIndex(const Key& serverID, const Snowflake<Role>& roleID) {
+		WriteLock indexesLock(locks.indexes);
+		unindexObject(serverID, roleID);
+	}
+
+	void ServerCache::removeFromIndex(const Key& serverID, const Snowflake<User>& userID) {
+		WriteLock indexesLock(locks.indexes);
+		unindexObject(serverID, userID);
+	}
+
+	void ServerCache::removeFromIndexes(const Server& server) {
+		WriteLock indexesLock(locks.indexes);
+		unindex(server.ID.raw(), server);
+	}
+
+	void ServerCache::unindexObject(const Key& serverID, const Snowflake<Channel>& channelID) {
+		SleepyDiscord::removeFromIndex(channelServers, serverID, channelID);
+	}
+
+	void ServerCache::unindexObject(const Key& serverID, const Snowflake<Role>& roleID) {
+		SleepyDiscord::removeFromIndex(roleServers, serverID, roleID);
+	}
+
+	void ServerCache::unindexObject(const Key& serverID, const Snowflake<User>& userID) {
+		SleepyDiscord::removeFromIndex(memberServers, serverID, userID);
+	}
+
+	void ServerCache::unindex(const Key& serverID, const Server& server) {
+		for (const Channel& channel : server.channels)
+			unindexObject(serverID, channel.ID);
+		for (const Role& role : server.roles)
+			unindexObject(serverID, role.ID);
+		for (const ServerMember& member : server.members)
+			unindexObject(serverID, member.ID);
+	}
+
+	void ServerCache::rebuildIndexes() {
+		WriteLock serversLock(locks.servers);
+		WriteLock indexesLock(locks.indexes);
+		channelServers.clear();
+		roleServers.clear();
+		memberServers.clear();
+		trackers.clear();
+		for (Server& server : *this) {
+			applyPolicies(server);
+			index(server.ID.raw(), server);
+		}
 	}
 
 	ServerMember::ServerMember(const json::Value & json) :
 		ServerMember(json::fromJSON<ServerMember>(json)) {
-		ID = user.ID;
 	}
 
 	Server::Server(const json::Value & json) :
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <iterator>
+#include "session_pool.h"
+
+namespace SleepyDiscord {
+	std::string SessionPool::getHost(const std::string& url) {
+		std::size_t start = url.find("://");
+		start = start == std::string::npos ? 0 : start + 3;
+		const std::size_t end = url.find('/', start);
+		return url.substr(0, end);
+	}
+
+	time_t SessionPool::getTime() {
+		auto ms = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now());
+		return ms.time_since_epoch().count();
+	}
+
+	SessionPool::Handle SessionPool::acquire(const std::string& url) {
+		std::string host = getHost(url);
+		//expired sessions are destroyed after the lock is gone, since closing them can take a while
+		IdleList expired;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			evictIdle(getTime(), expired);
+			auto found = idleSessions.find(host);
+			if (found != idleSessions.end() && !found->second.empty()) {
+				//the front was used last, so it's the most likely to still be connected
+				std::unique_ptr<Session> session = std::move(found->second.front().session);
+				found->second.pop_front();
+				return Handle(*this, std::move(host), std::move(session));
+			}
+		}
+		return Handle(*this, std::move(host), std::unique_ptr<Session>(new Session));
+	}
+
+	void SessionPool::release(const std::string& host, std::unique_ptr<Session> session) {
+		//destroy sessions that are over the limit outside of the lock
+		std::unique_ptr<Session> overflow;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			IdleList& idle = idleSessions[host];
+			if (idle.size() < settings.maxIdleSessions)
+				idle.push_front({ std::move(session), getTime() });
+			else
+				overflow = std::move(session);
+		}
+	}
+
+	void SessionPool::evictIdle(const time_t currentTime, IdleList& expired) {
+		for (auto host = idleSessions.begin(); host != idleSessions.end();) {
+			IdleList& idle = host->second;
+			//oldest sessions are at the back
+			while (!idle.empty() && settings.idleTimeout <= currentTime - idle.back().lastUsed)
+				expired.splice(expired.end(), idle, std::prev(idle.end()));
+			if (idle.empty())
+				host = idleSessions.erase(host);
+			else
+				++host;
+		}
+	}
+
+	void SessionPool::clear() {
+		std::unordered_map<std::string, IdleList> toDestroy;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			toDestroy.swap(idleSessions);
+		}
+	}
+
+	std::size_t SessionPool::size() {
+		std::lock_guard<std::mutex> lock(mutex);
+		std::size_t count = 0;
+		for (auto& host : idleSessions)
+			count += host.second.size();
+		return count;
+	}
+}
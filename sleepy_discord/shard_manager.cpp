@@ -0,0 +1,69 @@
+#include "shard_manager.h"
+#ifndef NONEXISTENT_ASIO
+
+namespace SleepyDiscord {
+	void IdentifyQueue::setBuckets(std::size_t bucketCount, const time_t intervalMilliseconds) {
+		std::lock_guard<std::mutex> lock(mutex);
+		interval = std::chrono::milliseconds(intervalMilliseconds);
+		buckets.clear();
+		buckets.reserve(bucketCount < 1 ? 1 : bucketCount);
+		for (std::size_t i = 0; i < buckets.capacity(); ++i)
+			buckets.emplace_back(new Bucket(io));
+	}
+
+	void IdentifyQueue::push(const int shardID, Identify identify) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (buckets.empty())
+			buckets.emplace_back(new Bucket(io));
+		Bucket& bucket = *buckets[static_cast<std::size_t>(shardID) % buckets.size()];
+		bucket.waiting.push_back(std::move(identify));
+		if (!bucket.isWaiting)
+			wait(bucket);
+	}
+
+	void IdentifyQueue::delay(const time_t milliseconds) {
+		std::lock_guard<std::mutex> lock(mutex);
+		const Clock::time_point until = Clock::now() + std::chrono::milliseconds(milliseconds);
+		for (std::unique_ptr<Bucket>& bucket : buckets) {
+			if (bucket->nextIdentify < until)
+				bucket->nextIdentify = until;
+			//buckets that are already waiting need to wait longer
+			if (bucket->isWaiting)
+				wait(*bucket);
+		}
+	}
+
+	void IdentifyQueue::wait(Bucket& bucket) {
+		bucket.isWaiting = true;
+		bucket.timer.expires_at(std::max(Clock::now(), bucket.nextIdentify));
+		bucket.timer.async_wait([this, &bucket](const asio::error_code& error) {
+			//the timer was moved by delay, and that wait will release the bucket instead
+			if (error != asio::error::operation_aborted)
+				release(bucket);
+		});
+	}
+
+	void IdentifyQueue::release(Bucket& bucket) {
+		Identify identify;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (bucket.waiting.empty() || Clock::now() < bucket.nextIdentify) {
+				//a cancel that came too late to abort this wait
+				if (!bucket.waiting.empty())
+					wait(bucket);
+				else
+					bucket.isWaiting = false;
+				return;
+			}
+			identify = std::move(bucket.waiting.front());
+			bucket.waiting.pop_front();
+			bucket.nextIdentify = Clock::now() + interval;
+			if (bucket.waiting.empty())
+				bucket.isWaiting = false;
+			else
+				wait(bucket);
+		}
+		identify();
+	}
+}
+#endif
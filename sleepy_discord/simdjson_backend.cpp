@@ -0,0 +1,121 @@
+#include "json_wrapper.h"
+#ifdef EXISTENT_SIMDJSON
+#include <climits>
+#include <string>
+#include <simdjson.h>
+
+namespace SleepyDiscord { namespace json { namespace Backend {
+	static_assert(padding == simdjson::SIMDJSON_PADDING, "json::Backend::padding needs to match simdjson's");
+
+	namespace {
+		//simdjson's dom parser is used, since it picks the fastest implementation for the
+		//cpu when running, and the on demand parser needs the library to be built for it
+		//The tape it makes is already checked, so this only walks it in the order rapidjson would
+		struct Reader {
+			Handler& handler;
+
+			//numbers go to the same handler function as they would from rapidjson
+			bool integer(const int64_t number) {
+				if (0 <= number)
+					return number <= UINT_MAX ?
+						handler.Uint(static_cast<unsigned>(number)) :
+						handler.Uint64(static_cast<uint64_t>(number));
+				return INT_MIN <= number ?
+					handler.Int(static_cast<int>(number)) :
+					handler.Int64(number);
+			}
+
+			bool read(const simdjson::dom::element element) {
+				switch (element.type()) {
+				case simdjson::dom::element_type::OBJECT: {
+					if (!handler.StartObject())
+						return false;
+					const simdjson::dom::object object = element.get_object().value_unsafe();
+					SizeType count = 0;
+					for (const simdjson::dom::key_value_pair field : object) {
+						if (!handler.Key(field.key.data(), field.key.length()) || !read(field.value))
+							return false;
+						++count;
+					}
+					return handler.EndObject(count);
+				}
+				case simdjson::dom::element_type::ARRAY: {
+					if (!handler.StartArray())
+						return false;
+					const simdjson::dom::array array = element.get_array().value_unsafe();
+					SizeType count = 0;
+					for (const simdjson::dom::element value : array) {
+						if (!read(value))
+							return false;
+						++count;
+					}
+					return handler.EndArray(count);
+				}
+				case simdjson::dom::element_type::STRING: {
+					const std::string_view string = element.get_string().value_unsafe();
+					return handler.String(string.data(), string.length());
+				}
+				case simdjson::dom::element_type::INT64: return integer(element.get_int64().value_unsafe());
+				case simdjson::dom::element_type::UINT64: return handler.Uint64(element.get_uint64().value_unsafe());
+				case simdjson::dom::element_type::DOUBLE: return handler.Double(element.get_double().value_unsafe());
+				case simdjson::dom::element_type::BOOL: return handler.Bool(element.get_bool().value_unsafe());
+				case simdjson::dom::element_type::NULL_VALUE: return handler.Null();
+				default: return false;
+				}
+			}
+		};
+
+		rapidjson::ParseErrorCode toParseErrorCode(const simdjson::error_code error) {
+			switch (error) {
+			case simdjson::EMPTY: return rapidjson::kParseErrorDocumentEmpty;
+			case simdjson::TAPE_ERROR: return rapidjson::kParseErrorDocumentRootNotSingular;
+			case simdjson::UNCLOSED_STRING: return rapidjson::kParseErrorStringMissQuotationMark;
+			case simdjson::UTF8_ERROR: return rapidjson::kParseErrorStringInvalidEncoding;
+			case simdjson::BIGINT_ERROR: return rapidjson::kParseErrorNumberTooBig;
+			case simdjson::NUMBER_ERROR: return rapidjson::kParseErrorNumberMissExponent;
+			default: return rapidjson::kParseErrorValueInvalid;
+			}
+		}
+
+		//the parser and the buffer for json without padding, kept for each thread
+		struct Buffers {
+			simdjson::dom::parser parser;
+			std::string paddedJSON;
+			bool isInUse = false;
+		};
+
+		rapidjson::ParseResult parse(Buffers& buffers, Handler& handler, const char* json, std::size_t length, std::size_t capacity) {
+			if (capacity < length + padding) {
+				buffers.paddedJSON.assign(json, length);
+				buffers.paddedJSON.resize(length + padding, ' ');
+				json = buffers.paddedJSON.data();
+			}
+
+			simdjson::dom::element root;
+			const simdjson::error_code error = buffers.parser.parse(json, length, false).get(root);
+			if (error)
+				return rapidjson::ParseResult(toParseErrorCode(error), 0);
+			Reader reader{ handler };
+			if (!reader.read(root))
+				return rapidjson::ParseResult(rapidjson::kParseErrorTermination, 0);
+			return rapidjson::ParseResult();
+		}
+	}
+
+	rapidjson::ParseResult parse(Handler& handler, const char* json, std::size_t length, std::size_t capacity) {
+		thread_local Buffers threadBuffers;
+		//a handler could parse some other json while handling a token
+		if (threadBuffers.isInUse) {
+			Buffers buffers;
+			return parse(buffers, handler, json, length, capacity);
+		}
+		struct Use {
+			Use(Buffers& _buffers) : buffers(_buffers) { buffers.isInUse = true; }
+			~Use() { buffers.isInUse = false; }
+			Buffers& buffers;
+		} use(threadBuffers);
+		return parse(threadBuffers, handler, json, length, capacity);
+	}
+}}}
+
+#endif
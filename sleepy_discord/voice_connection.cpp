@@ -79,7 +79,7 @@ namespace SleepyDiscord {
 		//json::Values values = json::getValues(message.c_str(),
 		//	{ "op", "d" });
 		rapidjson::Document values;
-		values.Parse(message.c_str(), message.length());
+		json::parse(values, message.data(), message.length(), message.capacity());
 
 		VoiceOPCode op = static_cast<VoiceOPCode>(json::toInt(values["op"]));
 		json::Value& d = values["d"];
@@ -19,20 +19,46 @@ namespace SleepyDiscord {
 		});
 	}
 
+	namespace {
+		//the strand of the handler that's running on this thread, if there's one
+		thread_local const std::shared_ptr<ConnectionStrand>* currentStrand = nullptr;
+
+		template<class Handler>
+		void runOnStrand(const std::shared_ptr<ConnectionStrand>& strand, Handler handler) {
+			strand->dispatch([strand, handler]() {
+				const std::shared_ptr<ConnectionStrand>* previousStrand = currentStrand;
+				currentStrand = &strand;
+				handler();
+				currentStrand = previousStrand;
+			});
+		}
+	}
+
 	WebsocketppDiscordClient::WebsocketppDiscordClient(const std::string token, const char numOfThreads) :
 		_thread(nullptr)
 	{
+		IOThreadPool::Settings threadSettings;
+		threadSettings.threadCount = 0 < numOfThreads ? static_cast<std::size_t>(numOfThreads) : 1;
+		ioThreads.setSettings(threadSettings);
 		init();
 		setScheduleHandler<WebsocketppScheduleHandler>(this_client);
 		start(token, numOfThreads);
 	}
 
+	WebsocketppDiscordClient::WebsocketppDiscordClient(asio::io_service& sharedIOService, const std::string token) :
+		ownsIOService(false), _thread(nullptr)
+	{
+		init(&sharedIOService);
+		setScheduleHandler<WebsocketppScheduleHandler>(this_client);
+		start(token);
+	}
+
 	WebsocketppDiscordClient::~WebsocketppDiscordClient() {
 		if (_thread != nullptr && _thread->joinable()) _thread->join();
 		else _thread.reset();
 	}
 
-	void WebsocketppDiscordClient::init() {
+	void WebsocketppDiscordClient::init(asio::io_service* sharedIOService) {
 		// set up access channels to only log interesting things
 		this_client.clear_access_channels(websocketpp::log::alevel::all);
 		this_client.set_access_channels(websocketpp::log::alevel::connect);
@@ -44,8 +70,12 @@ namespace SleepyDiscord {
 		});
 
 		// Initialize the Asio transport policy
-		this_client.init_asio();
+		if (sharedIOService != nullptr)
+			this_client.init_asio(sharedIOService);
+		else
+			this_client.init_asio();
 		this_client.start_perpetual();
+		gatewayStrand = std::make_shared<ConnectionStrand>(this_client.get_io_service());
 	}
 
 	bool WebsocketppDiscordClient::connect(const std::string & uri,
@@ -62,22 +92,37 @@ namespace SleepyDiscord {
 			return false;
 		}
 
-		con->set_open_handler(std::bind(&WebsocketppDiscordClient::onOpen, this,
-			websocketpp::lib::placeholders::_1, messageProcessor
-		));
+		//the gateway shares its strand with the timers, voice connections get their own
+		if (!gatewayStrand)
+			gatewayStrand = std::make_shared<ConnectionStrand>(this_client.get_io_service());
+		const std::shared_ptr<ConnectionStrand> strand = messageProcessor == this ? gatewayStrand :
+			std::make_shared<ConnectionStrand>(this_client.get_io_service());
+
+		con->set_open_handler([this, strand, messageProcessor](websocketpp::connection_hdl handle) {
+			runOnStrand(strand, [this, handle, messageProcessor]() {
+				onOpen(handle, messageProcessor);
+			});
+		});
 
-		con->set_close_handler(std::bind(&WebsocketppDiscordClient::onClose, this,
-			websocketpp::lib::placeholders::_1, messageProcessor
-		));
+		con->set_close_handler([this, strand, messageProcessor](websocketpp::connection_hdl handle) {
+			runOnStrand(strand, [this, handle, messageProcessor]() {
+				onClose(handle, messageProcessor);
+			});
+		});
 
-		con->set_message_handler(std::bind(&WebsocketppDiscordClient::onMessage, this,
-			websocketpp::lib::placeholders::_1, websocketpp::lib::placeholders::_2,
-			messageProcessor
-		));
+		con->set_message_handler([this, strand, messageProcessor](websocketpp::connection_hdl handle,
+			websocketpp::config::asio_client::message_type::ptr message
+		) {
+			runOnStrand(strand, [this, handle, message, messageProcessor]() {
+				onMessage(handle, message, messageProcessor);
+			});
+		});
 
-		con->set_fail_handler(std::bind(&WebsocketppDiscordClient::onFail, this,
-			websocketpp::lib::placeholders::_1, messageProcessor
-		));
+		con->set_fail_handler([this, strand, messageProcessor](websocketpp::connection_hdl handle) {
+			runOnStrand(strand, [this, handle, messageProcessor]() {
+				onFail(handle, messageProcessor);
+			});
+		});
 
 #ifdef SLEEPY_WEBSCOKETPP_PRINTALL
 		this_client.set_access_channels(websocketpp::log::alevel::all);
@@ -96,7 +141,8 @@ namespace SleepyDiscord {
 
 	void WebsocketppDiscordClient::run() {
 		BaseDiscordClient::connect();
-		this_client.run();
+		if (ownsIOService)
+			ioThreads.run(this_client.get_io_service());
 	}
 
 	void handleTimers(const websocketpp::lib::error_code &ec, std::function<void()>& code, _client::timer_ptr timer) {
@@ -120,6 +166,14 @@ namespace SleepyDiscord {
 	}
 
 	Timer WebsocketppDiscordClient::schedule(TimedTask code, const time_t milliseconds) {
+		//timers run in the strand they were scheduled from, or else the gateway's
+		const std::shared_ptr<ConnectionStrand> strand =
+			currentStrand != nullptr ? *currentStrand : gatewayStrand;
+		if (strand) {
+			code = [strand, code]() {
+				runOnStrand(strand, code);
+			};
+		}
 		_client::timer_ptr timer;
 		auto callback = std::bind(
 			&handleTimers, websocketpp::lib::placeholders::_1, code, timer);
@@ -150,6 +204,11 @@ namespace SleepyDiscord {
 		//Besides the library can detect bad connections by itself anyway
 	}
 
+	void WebsocketppDiscordClient::sendBinary(std::string message, WebsocketConnection& _connection) {
+		websocketpp::lib::error_code error;
+		this_client.send(_connection, message, websocketpp::frame::opcode::binary, error);
+	}
+
 	void WebsocketppDiscordClient::onOpen(websocketpp::connection_hdl hdl,
 		GenericMessageReceiver* messageProcessor) {
 		initialize(messageProcessor);
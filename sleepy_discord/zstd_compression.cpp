@@ -0,0 +1,38 @@
+#include "zstd_compression.h"
+#ifdef EXISTENT_ZSTD
+
+namespace SleepyDiscord {
+	ZstdCompression::ZstdCompression() : stream(ZSTD_createDStream()) {
+		ZSTD_initDStream(stream);
+	}
+
+	ZstdCompression::~ZstdCompression() {
+		ZSTD_freeDStream(stream);
+	}
+
+	void ZstdCompression::uncompress(const std::string& compressed) {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		ZSTD_inBuffer input = { compressed.data(), compressed.length(), 0 };
+		while (true) {
+			output.prepare();
+			ZSTD_outBuffer target = { output.begin(), output.available(), 0 };
+			statusCode = ZSTD_decompressStream(stream, &target, &input);
+			if (ZSTD_isError(statusCode)) {
+				//don't hand on part of a message
+				output.size = 0;
+				break;
+			}
+			output.size += target.pos;
+			//when zstd didn't fill the output, everything it has so far has been flushed
+			if (input.pos == input.size && target.pos < target.size)
+				break;
+		}
+	}
+
+	void ZstdCompression::getOutput(std::string& uncompressedOut) {
+		std::lock_guard<std::mutex> lock(mutex);
+		output.moveTo(uncompressedOut);
+	}
+}
+#endif